@@ -0,0 +1,273 @@
+// Benchmarks for the simulation hot paths.
+//
+// Build from the repo root against SFML, e.g.
+//   g++ -std=c++17 -O2 bench/Benchmark.cpp -o benchmark -lsfml-graphics -lsfml-window -lsfml-audio -lsfml-system
+// and run it from the directory that contains Data/:
+//   benchmark [output file] [scale]
+// Each result is written as one JSON object per line (default bench_output.txt) so
+// runs from different commits can be diffed or plotted. scale multiplies the
+// iteration counts; use it to trade run time for stability.
+//
+// startup.firstFrame covers what Game::run() does before its first menu frame:
+// construction, loading every asset, createWorld() and the Menu. Opening the
+// window and drawing the loading screen and the menu itself are left out, but
+// the textures are still uploaded, so this one needs a display (a GL context).
+// Everything else here runs headless.
+
+#include "../header/Game.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <atomic>
+
+// Every heap allocation in the process goes through here so a benchmark can
+// report how many allocations one operation costs.
+static atomic<unsigned long long> allocationCount(0); // loader and logger threads allocate too
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+struct BenchResult {
+    string name;
+    int level;
+    long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// A quantity read once rather than timed, e.g. memory a level keeps resident.
+struct BenchGauge {
+    string name;
+    int level;
+    double value;
+};
+
+// Runs body() iterations times after a short warm-up and returns the averages.
+template <typename Body>
+BenchResult measure(const string& name, int level, long long iterations, Body body) {
+    for (long long i = 0; i < iterations / 10 + 1; ++i) body();
+
+    unsigned long long allocsBefore = allocationCount;
+    auto start = chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; ++i) body();
+    auto end = chrono::steady_clock::now();
+
+    BenchResult result;
+    result.name = name;
+    result.level = level;
+    result.iterations = iterations;
+    result.nsPerOp = chrono::duration<double, nano>(end - start).count() / iterations;
+    result.allocsPerOp = double(allocationCount - allocsBefore) / iterations;
+    return result;
+}
+
+// Friend of Game and Character so the private update passes can be timed in isolation.
+class GameBench {
+public:
+    GameBench(Game& game) : game(game) {}
+
+    void horizontalCollision() {
+        for (int i = 0; i < 3; ++i) {
+            game.characters[i]->applyHorizontalCollision(game.tiles);
+        }
+    }
+
+    void verticalCollision() {
+        for (int i = 0; i < 3; ++i) {
+            game.characters[i]->applyVerticalCollision(game.tiles);
+        }
+    }
+
+    void updateEnemies() {
+        Character* main = game.characters[game.mainIndex];
+        for (int i = 0; i < game.enemyCount; ++i) {
+            game.enemies[i]->update(3.0f, 19.0f, game.tiles, game.pathFinder, FIXED_TIMESTEP,
+                main->getPosX(), main->getPosY(), false);
+        }
+    }
+
+    // One uncached walker search from the main character towards the far end
+    // of the level, pumped frame by frame until it is done.
+    void searchPath() {
+        Character* main = game.characters[game.mainIndex];
+        int fromCol = static_cast<int>((main->getPosX() + main->getWidth() / 2.0f) / CELL_SIZE);
+        int fromRow = static_cast<int>((main->getPosY() + main->getHeight() - 1) / CELL_SIZE);
+        int bodyRows = static_cast<int>((main->getHeight() + CELL_SIZE - 1) / CELL_SIZE);
+        // The rightmost cell with room to stand in.
+        int goalCol = game.tiles.getCols() - 1;
+        int goalRow = -1;
+        while (goalRow < 0 && --goalCol > 0) {
+            for (int row = game.tiles.getRows() - 2; row >= bodyRows; --row) {
+                bool open = true;
+                for (int y = row - bodyRows + 1; y <= row; ++y) open = open && tileFlags(game.tiles.get(goalCol, y)) == 0;
+                if (open && tileHas(game.tiles.get(goalCol, row + 1), TILE_FLOOR)) {
+                    goalRow = row;
+                    break;
+                }
+            }
+        }
+        PathFinder::Step step;
+        game.pathFinder.clear();
+        game.pathFinder.nextStep(game.tiles, PathFinder::WALKER, bodyRows, 2, fromCol, fromRow, goalCol, goalRow, step);
+        while (game.pathFinder.getPendingCount() > 0) game.pathFinder.update(game.tiles);
+    }
+
+    void checkCollisions() { game.checkCollisions(FIXED_TIMESTEP); }
+    void updateCollectables() { game.updateCollectables(); }
+
+    void loadMap(int level) {
+        game.loadMap("Data/map_" + to_string(level) + ".txt");
+    }
+
+    void simulateFrame(const InputState& input) { game.simulateFrame(FIXED_TIMESTEP, input); }
+
+    // The asset part of a start: queue every texture and wait until the atlas is
+    // complete. A headless game only decodes them. Building the world and the
+    // menu is not included.
+    void loadAssets() {
+        game.beginAssetLoading();
+        game.atlas.finish();
+        game.applyLoadedAssets();
+        game.backgroundMusic.stop();
+    }
+    // run() up to its first menu frame, without the window: the uploads are
+    // waited for instead of shown behind the loading screen. False if the
+    // assets could not be queued.
+    static bool startToFirstFrame() {
+        Game game(false);
+        if (game.assetsFailed) return false;
+        game.atlas.finish();
+        game.createWorld();
+        Menu menu(game.assets, *game.font, game.backgroundMusic);
+        game.backgroundMusic.stop();
+        return !game.tiles.isEmpty();
+    }
+
+    size_t getLevelTextureBytes() const { return game.levelTextureBytes; }
+    bool isGameOver() const { return game.sharedHP <= 0; }
+    int getEnemyCount() const { return game.enemyCount; }
+
+private:
+    Game& game;
+};
+
+// Right held the whole time with a jump every 45 frames; walks most of a level.
+static InputState scriptedInput(long long frame) {
+    InputState input;
+    input.right = true;
+    input.up = frame % 45 < 2;
+    return input;
+}
+
+int main(int argc, char** argv) {
+    const char* outputPath = argc > 1 ? argv[1] : "bench_output.txt";
+    long long scale = argc > 2 ? atoll(argv[2]) : 1;
+    if (scale < 1) scale = 1;
+
+    ofstream out(outputPath);
+    if (!out.is_open()) {
+        cout << "BENCH ERROR: Could not open " << outputPath << "\n";
+        return 1;
+    }
+
+    BenchResult results[32];
+    int resultCount = 0;
+
+    // Startup latency from constructing the game to the point run() draws its
+    // first menu frame (see the note at the top).
+    if (!GameBench::startToFirstFrame()) {
+        cout << "BENCH ERROR: Could not load the startup assets\n";
+        return 1;
+    }
+    results[resultCount++] = measure("startup.firstFrame", 0, 5 * scale, [&] {
+        GameBench::startToFirstFrame();
+    });
+
+    // Texture memory each level keeps resident, loading the levels in turn as
+    // a player would so textures shared between levels stay loaded. Sizes come
+    // from the decoded images, so no display is needed.
+    BenchGauge gauges[8];
+    int gaugeCount = 0;
+    {
+        Game game(true);
+        GameBench bench(game);
+        bench.loadAssets();
+        for (int level = 1; level <= 3; ++level) {
+            if (!game.initializeLevel(level)) {
+                cout << "BENCH ERROR: Could not load level " << level << "\n";
+                return 1;
+            }
+            BenchGauge& gauge = gauges[gaugeCount++];
+            gauge.name = "level.peakTextureBytes";
+            gauge.level = level;
+            gauge.value = static_cast<double>(bench.getLevelTextureBytes());
+        }
+    }
+
+    for (int level = 1; level <= 3; ++level) {
+        Game game(true);
+        GameBench bench(game);
+        if (!game.initializeLevel(level)) {
+            cout << "BENCH ERROR: Could not load level " << level << "\n";
+            return 1;
+        }
+
+        results[resultCount++] = measure("character.applyHorizontalCollision", level, 200000 * scale,
+            [&] { bench.horizontalCollision(); });
+        results[resultCount++] = measure("character.applyVerticalCollision", level, 200000 * scale,
+            [&] { bench.verticalCollision(); });
+        if (bench.getEnemyCount() > 0) {
+            results[resultCount++] = measure("enemy.update", level, 50000 * scale,
+                [&] { bench.updateEnemies(); });
+        }
+        results[resultCount++] = measure("paths.search", level, 2000 * scale,
+            [&] { bench.searchPath(); });
+        results[resultCount++] = measure("game.checkCollisions", level, 50000 * scale,
+            [&] { bench.checkCollisions(); });
+        results[resultCount++] = measure("game.updateCollectables", level, 200000 * scale,
+            [&] { bench.updateCollectables(); });
+        results[resultCount++] = measure("game.loadMap", level, 200 * scale,
+            [&] { bench.loadMap(level); });
+
+        // Full simulation steps from a fresh level start, restarting on game over.
+        game.initializeLevel(level);
+        long long frame = 0;
+        results[resultCount++] = measure("frame.headless", level, 3600 * scale, [&] {
+            if (bench.isGameOver()) {
+                game.initializeLevel(level);
+                frame = 0;
+            }
+            bench.simulateFrame(scriptedInput(frame++));
+        });
+    }
+
+    for (int i = 0; i < resultCount; ++i) {
+        const BenchResult& r = results[i];
+        char line[256];
+        snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"level\":%d,\"iterations\":%lld,\"ns_per_op\":%.1f,\"allocs_per_op\":%.3f,\"ops_per_sec\":%.1f}",
+            r.name.c_str(), r.level, r.iterations, r.nsPerOp, r.allocsPerOp, 1e9 / r.nsPerOp);
+        out << line << "\n";
+        printf("%-36s level %d  %12.1f ns/op  %8.3f allocs/op  %12.1f ops/s\n",
+            r.name.c_str(), r.level, r.nsPerOp, r.allocsPerOp, 1e9 / r.nsPerOp);
+    }
+    for (int i = 0; i < gaugeCount; ++i) {
+        const BenchGauge& g = gauges[i];
+        char line[256];
+        snprintf(line, sizeof(line), "{\"name\":\"%s\",\"level\":%d,\"value\":%.0f}", g.name.c_str(), g.level, g.value);
+        out << line << "\n";
+        printf("%-36s level %d  %12.0f\n", g.name.c_str(), g.level, g.value);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Packs sprite images into as few square atlas pages as fit and writes the
+// manifest header/TextureAtlas.h reads. Run from the game directory so the
+// recorded paths match the ones the game asks for:
+//
+//   atlas_packer Data/atlas 2048 Data/brick1.png Data/ring.png ...
+//
+// writes Data/atlas_0.png, Data/atlas_1.png, ... and Data/atlas.txt. Images
+// are placed on shelves, tallest first, with a transparent gutter between them
+// so filtering never samples a neighbour.
+
+const int GUTTER = 2;
+
+struct PackedImage {
+    std::string path;
+    sf::Image image;
+    int page, x, y;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <output prefix> <page size> <image>..." << std::endl;
+        return 1;
+    }
+    std::string prefix = argv[1];
+    int pageSize = std::stoi(argv[2]);
+
+    std::vector<PackedImage> images(argc - 3);
+    for (int i = 3; i < argc; ++i) {
+        PackedImage& packed = images[i - 3];
+        packed.path = argv[i];
+        if (!packed.image.loadFromFile(packed.path)) {
+            std::cerr << "Error: Could not load " << packed.path << std::endl;
+            return 1;
+        }
+        int w = static_cast<int>(packed.image.getSize().x);
+        int h = static_cast<int>(packed.image.getSize().y);
+        if (w + GUTTER > pageSize || h + GUTTER > pageSize) {
+            std::cerr << "Error: " << packed.path << " (" << w << "x" << h << ") does not fit a " << pageSize << " page" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<PackedImage*> order;
+    for (size_t i = 0; i < images.size(); ++i) order.push_back(&images[i]);
+    std::stable_sort(order.begin(), order.end(), [](const PackedImage* a, const PackedImage* b) {
+        return a->image.getSize().y > b->image.getSize().y;
+    });
+
+    // Shelf packing: fill a row left to right, start a new row below the
+    // tallest image of the current one, and a new page when rows run out.
+    int page = 0, shelfX = 0, shelfY = 0, shelfHeight = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        int w = static_cast<int>(order[i]->image.getSize().x) + GUTTER;
+        int h = static_cast<int>(order[i]->image.getSize().y) + GUTTER;
+        if (shelfX + w > pageSize) {
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (shelfY + h > pageSize) {
+            page++;
+            shelfX = shelfY = shelfHeight = 0;
+        }
+        order[i]->page = page;
+        order[i]->x = shelfX;
+        order[i]->y = shelfY;
+        shelfX += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    int pageCount = page + 1;
+
+    std::ofstream manifest(prefix + ".txt");
+    if (!manifest.is_open()) {
+        std::cerr << "Error: Could not create " << prefix << ".txt" << std::endl;
+        return 1;
+    }
+    for (int p = 0; p < pageCount; ++p) {
+        sf::Image atlas;
+        atlas.create(pageSize, pageSize, sf::Color(0, 0, 0, 0));
+        for (size_t i = 0; i < images.size(); ++i) {
+            if (images[i].page == p) atlas.copy(images[i].image, images[i].x, images[i].y);
+        }
+        std::string pagePath = prefix + "_" + std::to_string(p) + ".png";
+        if (!atlas.saveToFile(pagePath)) {
+            std::cerr << "Error: Could not write " << pagePath << std::endl;
+            return 1;
+        }
+        manifest << "page " << p << " " << pagePath << "\n";
+    }
+    // Entries keep the command line order so the manifest diffs cleanly.
+    for (size_t i = 0; i < images.size(); ++i) {
+        manifest << images[i].path << " " << images[i].page << " " << images[i].x << " " << images[i].y << " "
+            << images[i].image.getSize().x << " " << images[i].image.getSize().y << "\n";
+    }
+
+    std::cout << "Packed " << images.size() << " images into " << pageCount << " page(s) of " << pageSize << "x" << pageSize << std::endl;
+    return 0;
+}
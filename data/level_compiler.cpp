@@ -0,0 +1,97 @@
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <string>
+#include "../header/LevelFormat.h"
+
+// Packs a level's map, enemies and collectables text files into the compiled
+// blob the game loads with a single read (see header/LevelFormat.h).
+//
+// Usage: level_compiler map_1.txt enemies_1.txt collectables_1.txt level_1.bin
+
+// Must match TileGrid::DEFAULT_PADDING so the tile image can be copied as is.
+const uint32_t TILE_PADDING = 2;
+
+uint32_t alignTo4(uint32_t offset) {
+    return (offset + 3) & ~3u;
+}
+
+bool readEntities(const char* filename, std::vector<LevelEntity>& entities) {
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        std::cerr << "Error: Could not open " << filename << std::endl;
+        return false;
+    }
+    LevelEntity entity = {};
+    while (in >> entity.type >> entity.x >> entity.y) {
+        entities.push_back(entity);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <map.txt> <enemies.txt> <collectables.txt> <level.bin>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream mapIn(argv[1]);
+    if (!mapIn.is_open()) {
+        std::cerr << "Error: Could not open " << argv[1] << std::endl;
+        return 1;
+    }
+    int rows, cols;
+    mapIn >> rows >> cols;
+    if (rows <= 0 || cols <= 0 || static_cast<uint32_t>(rows) > LEVEL_MAX_ROWS || static_cast<uint32_t>(cols) > LEVEL_MAX_COLS) {
+        std::cerr << "Error: Invalid dimensions in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    LevelHeader header = {};
+    memcpy(header.magic, LEVEL_MAGIC, 4);
+    header.version = LEVEL_VERSION;
+    header.headerSize = sizeof(LevelHeader);
+    header.rows = rows;
+    header.cols = cols;
+    header.padding = TILE_PADDING;
+    header.stride = cols + 2 * TILE_PADDING;
+
+    std::vector<char> tiles(static_cast<size_t>(levelTileImageSize(header)), ' ');
+    std::string line;
+    std::getline(mapIn, line);
+    int y = 0;
+    while (y < rows && std::getline(mapIn, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty()) continue;
+        for (int x = 0; x < cols && x < static_cast<int>(line.size()); ++x) {
+            tiles[(y + TILE_PADDING) * header.stride + x + TILE_PADDING] = line[x];
+        }
+        y++;
+    }
+
+    std::vector<LevelEntity> enemies, collectables;
+    if (!readEntities(argv[2], enemies) || !readEntities(argv[3], collectables)) return 1;
+
+    header.tilesOffset = sizeof(LevelHeader);
+    header.enemiesOffset = alignTo4(header.tilesOffset + static_cast<uint32_t>(tiles.size()));
+    header.enemyCount = static_cast<uint32_t>(enemies.size());
+    header.collectablesOffset = header.enemiesOffset + header.enemyCount * sizeof(LevelEntity);
+    header.collectableCount = static_cast<uint32_t>(collectables.size());
+    header.fileSize = header.collectablesOffset + header.collectableCount * sizeof(LevelEntity);
+
+    std::vector<char> blob(header.fileSize, 0);
+    memcpy(&blob[0], &header, sizeof(header));
+    memcpy(&blob[header.tilesOffset], &tiles[0], tiles.size());
+    if (!enemies.empty()) memcpy(&blob[header.enemiesOffset], &enemies[0], enemies.size() * sizeof(LevelEntity));
+    if (!collectables.empty()) memcpy(&blob[header.collectablesOffset], &collectables[0], collectables.size() * sizeof(LevelEntity));
+
+    std::ofstream out(argv[4], std::ios::binary | std::ios::trunc);
+    if (!out.is_open() || !out.write(&blob[0], blob.size())) {
+        std::cerr << "Error: Could not write " << argv[4] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << argv[4] << ": " << rows << " x " << cols << ", " << enemies.size()
+        << " enemies, " << collectables.size() << " collectables" << std::endl;
+    return 0;
+}
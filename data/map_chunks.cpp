@@ -0,0 +1,81 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cstdint>
+
+// Converts a text map (map_N.txt) into the chunked layout the game streams
+// (map_N.chunks, see header/LevelStream.h):
+//   "SHCK" | u16 version | u16 rows | u32 cols | u16 chunkWidth
+//   then ceil(cols / chunkWidth) chunks of rows * chunkWidth bytes, each a strip
+//   of whole columns stored row by row, the last one padded with ' '.
+//
+// Usage: map_chunks map_1.txt map_1.chunks [chunkWidth]
+
+void writeU16(std::ofstream& out, uint16_t value) {
+    unsigned char bytes[2] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8) };
+    out.write(reinterpret_cast<const char*>(bytes), 2);
+}
+
+void writeU32(std::ofstream& out, uint32_t value) {
+    unsigned char bytes[4] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+        static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24) };
+    out.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <map.txt> <map.chunks> [chunkWidth]" << std::endl;
+        return 1;
+    }
+    int chunkWidth = argc > 3 ? std::stoi(argv[3]) : 64;
+
+    std::ifstream in(argv[1]);
+    if (!in.is_open()) {
+        std::cerr << "Error: Could not open " << argv[1] << std::endl;
+        return 1;
+    }
+    int rows, cols;
+    in >> rows >> cols;
+    if (rows <= 0 || cols <= 0 || rows > 0xFFFF || chunkWidth <= 0 || chunkWidth > 0xFFFF) {
+        std::cerr << "Error: Invalid dimensions in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    int chunkCount = (cols + chunkWidth - 1) / chunkWidth;
+    int paddedCols = chunkCount * chunkWidth;
+    char* map = new char[rows * paddedCols];
+    for (int i = 0; i < rows * paddedCols; ++i) map[i] = ' ';
+
+    std::string line;
+    std::getline(in, line);
+    int y = 0;
+    while (y < rows && std::getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty()) continue;
+        for (int x = 0; x < cols && x < static_cast<int>(line.size()); ++x) {
+            map[y * paddedCols + x] = line[x];
+        }
+        y++;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create " << argv[2] << std::endl;
+        delete[] map;
+        return 1;
+    }
+    out.write("SHCK", 4);
+    writeU16(out, 1);
+    writeU16(out, static_cast<uint16_t>(rows));
+    writeU32(out, static_cast<uint32_t>(cols));
+    writeU16(out, static_cast<uint16_t>(chunkWidth));
+    for (int c = 0; c < chunkCount; ++c) {
+        for (int row = 0; row < rows; ++row) {
+            out.write(map + row * paddedCols + c * chunkWidth, chunkWidth);
+        }
+    }
+
+    std::cout << "Wrote " << argv[2] << ": " << rows << " x " << cols << " in " << chunkCount << " chunks of " << chunkWidth << " columns" << std::endl;
+    delete[] map;
+    return 0;
+}
@@ -1,40 +1,150 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include "SpriteSheet.h"
+#include "Logger.h"
 
-class Animation {
+// One animation strip: frameCount frames the size of firstFrame, laid out left
+// to right across a sheet. Never changes once registered, so every entity
+// playing the same strip shares it.
+struct AnimationClip {
+    sf::Texture* texture;
+    sf::IntRect firstFrame;
+    int frameCount;
+    float frameDuration;
+
+    sf::IntRect getFrame(int index) const {
+        return sf::IntRect(firstFrame.left + index * firstFrame.width, firstFrame.top, firstFrame.width, firstFrame.height);
+    }
+};
+
+// Registry of the clips in use, deduplicated by sheet, frame size and timing.
+// A slot is reused once the last AnimationState playing it is gone. Slot
+// FALLBACK is reserved: a single empty frame of an empty texture, handed out
+// when the registry is full so a clip id can always be looked up.
+class AnimationClips {
 public:
-    Animation(sf::Texture* texture, int frameWidth, int frameHeight, int frameCount, float frameDuration)
-        : texture(texture), frameCount(frameCount), frameDuration(frameDuration),
-          currentFrame(0), animationTimer(0.0f)
-    {
-        frames = new sf::IntRect[frameCount];
-        for (int i = 0; i < frameCount; ++i) {
-            frames[i] = sf::IntRect(i * frameWidth, 0, frameWidth, frameHeight);
+    static const int MAX_CLIPS = 256;
+    static const int FALLBACK = 0;
+
+    static AnimationClips& shared() {
+        static AnimationClips clips;
+        return clips;
+    }
+
+    // Returns the id of the matching clip, registering it if needed, or
+    // FALLBACK if the registry is full.
+    int acquire(const SpriteSheet& sheet, int frameWidth, int frameHeight, int frameCount, float frameDuration) {
+        // Unloaded textures (headless runs) report a width of 0, so always keep at least one frame.
+        AnimationClip clip;
+        clip.texture = sheet.texture;
+        clip.firstFrame = sf::IntRect(sheet.rect.left, sheet.rect.top, frameWidth, frameHeight);
+        clip.frameCount = frameCount > 0 ? frameCount : 1;
+        clip.frameDuration = frameDuration;
+
+        int freeSlot = -1;
+        for (int i = FALLBACK + 1; i < clipCount; ++i) {
+            if (refs[i] == 0) {
+                if (freeSlot < 0) freeSlot = i;
+            }
+            else if (matches(clips[i], clip)) {
+                refs[i]++;
+                return i;
+            }
+        }
+        if (freeSlot < 0) {
+            if (clipCount >= MAX_CLIPS) {
+                LOG_ERROR("ANIMATION ERROR: Clip registry full");
+                return FALLBACK;
+            }
+            freeSlot = clipCount++;
         }
+        clips[freeSlot] = clip;
+        refs[freeSlot] = 1;
+        return freeSlot;
     }
 
-    ~Animation() {
-        delete[] frames;
+    void addRef(int clip) { if (clip != FALLBACK) refs[clip]++; }
+    void release(int clip) { if (clip != FALLBACK) refs[clip]--; }
+
+    const AnimationClip& get(int clip) const { return clips[clip]; }
+
+    int getActiveCount() const {
+        int active = 0;
+        for (int i = FALLBACK + 1; i < clipCount; ++i) {
+            if (refs[i] > 0) active++;
+        }
+        return active;
     }
 
+private:
+    AnimationClip clips[MAX_CLIPS];
+    int refs[MAX_CLIPS];
+    int clipCount;
+    sf::Texture emptyTexture;
+
+    AnimationClips() : clipCount(FALLBACK + 1) {
+        clips[FALLBACK].texture = &emptyTexture;
+        clips[FALLBACK].firstFrame = sf::IntRect(0, 0, 0, 0);
+        clips[FALLBACK].frameCount = 1;
+        clips[FALLBACK].frameDuration = 0.0f;
+        refs[FALLBACK] = 0;
+    }
+    AnimationClips(const AnimationClips&) = delete;
+    AnimationClips& operator=(const AnimationClips&) = delete;
+
+    static bool matches(const AnimationClip& a, const AnimationClip& b) {
+        return a.texture == b.texture && a.firstFrame == b.firstFrame &&
+            a.frameCount == b.frameCount && a.frameDuration == b.frameDuration;
+    }
+};
+
+// Where one entity is in a shared clip. A default-constructed state, or one
+// the full registry could not hold, plays the empty fallback clip; check
+// isValid() before drawing from it.
+class AnimationState {
+public:
+    AnimationState() : clip(AnimationClips::FALLBACK), currentFrame(0), animationTimer(0.0f) {}
+
+    AnimationState(const SpriteSheet& sheet, int frameWidth, int frameHeight, int frameCount, float frameDuration)
+        : clip(AnimationClips::shared().acquire(sheet, frameWidth, frameHeight, frameCount, frameDuration)),
+          currentFrame(0), animationTimer(0.0f) {}
+
+    AnimationState(const AnimationState& other)
+        : clip(other.clip), currentFrame(other.currentFrame), animationTimer(other.animationTimer) {
+        AnimationClips::shared().addRef(clip);
+    }
+
+    AnimationState& operator=(const AnimationState& other) {
+        AnimationClips::shared().addRef(other.clip);
+        AnimationClips::shared().release(clip);
+        clip = other.clip;
+        currentFrame = other.currentFrame;
+        animationTimer = other.animationTimer;
+        return *this;
+    }
+
+    ~AnimationState() {
+        AnimationClips::shared().release(clip);
+    }
+
+    bool isValid() const { return clip != AnimationClips::FALLBACK; }
+
     void update(float deltaTime) {
-        if (frameCount <= 1) return;
+        const AnimationClip& data = AnimationClips::shared().get(clip);
+        if (data.frameCount <= 1) return;
         animationTimer += deltaTime;
-        if (animationTimer >= frameDuration) {
-            animationTimer -= frameDuration;
-            currentFrame = (currentFrame + 1) % frameCount;
+        if (animationTimer >= data.frameDuration) {
+            animationTimer -= data.frameDuration;
+            currentFrame = (currentFrame + 1) % data.frameCount;
         }
     }
 
-    sf::Texture* getTexture() const { return texture; }
-    sf::IntRect getCurrentFrame() const { return frames[currentFrame]; }
+    sf::Texture* getTexture() const { return AnimationClips::shared().get(clip).texture; }
+    sf::IntRect getCurrentFrame() const { return AnimationClips::shared().get(clip).getFrame(currentFrame); }
     void reset() { currentFrame = 0; animationTimer = 0.0f; }
 
 private:
-    sf::Texture* texture;
-    sf::IntRect* frames;
-    int frameCount;
-    float frameDuration;
+    int clip;
     int currentFrame;
     float animationTimer;
-};
\ No newline at end of file
+};
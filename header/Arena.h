@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Bump allocator for objects that live exactly as long as a level. create()
+// places each object after the previous one in a large block, and reset()
+// destroys them all, newest first, and rewinds to the start, so a level
+// reload frees everything at once and the next level reuses the same memory.
+// Blocks are only ever added, never returned, until the arena itself goes.
+//
+// Every object carries a small record in front of it naming its destructor,
+// so types with different sizes and destructors can share one arena; objects
+// are destroyed through their own type, never a base class.
+class Arena {
+public:
+    static const size_t BLOCK_SIZE = 256 * 1024;
+
+    Arena() : first(nullptr), current(nullptr), last(nullptr), bytesUsed(0) {}
+
+    ~Arena() {
+        reset();
+        while (first) {
+            Block* next = first->next;
+            ::operator delete(first);
+            first = next;
+        }
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Arena blocks are only max_align_t aligned");
+        char* memory = allocate(alignof(T), sizeof(T));
+        T* object = new (memory + recordSize(alignof(T))) T(std::forward<Args>(args)...);
+        Record* record = new (memory) Record;
+        record->object = object;
+        record->destroy = &destroy<T>;
+        record->previous = last;
+        last = record;
+        return object;
+    }
+
+    void reset() {
+        for (Record* record = last; record; record = record->previous) record->destroy(record->object);
+        last = nullptr;
+        for (Block* block = first; block; block = block->next) block->used = 0;
+        current = first;
+        bytesUsed = 0;
+    }
+
+    size_t getBytesUsed() const { return bytesUsed; }
+
+private:
+    struct Record {
+        void* object;
+        void (*destroy)(void*);
+        Record* previous;
+    };
+
+    struct Block {
+        Block* next;
+        size_t size;
+        size_t used;
+        char* data() { return reinterpret_cast<char*>(this) + headerSize(); }
+    };
+
+    Block* first;
+    Block* current;
+    Record* last;
+    size_t bytesUsed;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template <typename T>
+    static void destroy(void* object) { static_cast<T*>(object)->~T(); }
+
+    static size_t alignUp(size_t n, size_t alignment) { return (n + alignment - 1) & ~(alignment - 1); }
+    static size_t headerSize() { return alignUp(sizeof(Block), alignof(std::max_align_t)); }
+
+    // Offset of an object from its record, keeping both aligned.
+    static size_t recordSize(size_t alignment) {
+        return alignUp(sizeof(Record), alignment > alignof(Record) ? alignment : alignof(Record));
+    }
+
+    // Room for a record and an object behind it. Moves on to the next block,
+    // or adds one, when the current block is full.
+    char* allocate(size_t alignment, size_t size) {
+        size_t align = alignment > alignof(Record) ? alignment : alignof(Record);
+        size_t needed = recordSize(alignment) + size;
+        while (current) {
+            size_t offset = alignUp(current->used, align);
+            if (offset + needed <= current->size) {
+                current->used = offset + needed;
+                bytesUsed += needed;
+                return current->data() + offset;
+            }
+            if (!current->next) break;
+            current = current->next;
+        }
+        size_t capacity = needed + align > BLOCK_SIZE ? needed + align : BLOCK_SIZE;
+        Block* block = static_cast<Block*>(::operator new(headerSize() + capacity));
+        block->next = nullptr;
+        block->size = capacity;
+        block->used = 0;
+        if (current) current->next = block;
+        else first = block;
+        current = block;
+        return allocate(alignment, size);
+    }
+};
@@ -0,0 +1,200 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include "Logger.h"
+#include <string>
+#include <cstddef>
+
+template <typename T> class AssetTable;
+
+// Shared reference to one cached asset. Copies count as users of the asset;
+// once the last handle to it is gone, AssetCache::evictUnused() may free it.
+// A handle must not outlive the cache it came from.
+template <typename T>
+class AssetHandle {
+public:
+    AssetHandle() : table(nullptr), slot(-1) {}
+
+    AssetHandle(AssetTable<T>* table, int slot) : table(table), slot(slot) {
+        if (table) table->slots[slot].refs++;
+    }
+
+    AssetHandle(const AssetHandle& other) : AssetHandle(other.table, other.slot) {}
+
+    AssetHandle& operator=(const AssetHandle& other) {
+        if (other.table) other.table->slots[other.slot].refs++;
+        reset();
+        table = other.table;
+        slot = other.slot;
+        return *this;
+    }
+
+    ~AssetHandle() {
+        reset();
+    }
+
+    void reset() {
+        if (table) table->slots[slot].refs--;
+        table = nullptr;
+        slot = -1;
+    }
+
+    bool isValid() const { return table != nullptr; }
+    bool isLoaded() const { return table && table->slots[slot].loaded; }
+    const std::string& getPath() const { return table->slots[slot].path; }
+
+    // Reads the asset from its path unless another handle already did.
+    bool load() {
+        if (!table) return false;
+        typename AssetTable<T>::Slot& entry = table->slots[slot];
+        if (!entry.loaded) {
+            entry.loaded = entry.asset->loadFromFile(entry.path);
+            if (!entry.loaded) LOG_ERROR("ASSET ERROR: Could not load %s", entry.path.c_str());
+        }
+        return entry.loaded;
+    }
+
+    // For assets filled in some other way, like an atlas page uploaded from
+    // an image decoded off the main thread.
+    void markLoaded() {
+        if (table) table->slots[slot].loaded = true;
+    }
+
+    T* get() const { return table->slots[slot].asset; }
+    T& operator*() const { return *get(); }
+    T* operator->() const { return get(); }
+
+private:
+    AssetTable<T>* table;
+    int slot;
+};
+
+// Path-keyed assets of one type. Each asset is allocated once, so its address
+// stays put for as long as it is cached, and evicted slots are reused.
+template <typename T>
+class AssetTable {
+public:
+    static const int MAX_ASSETS = 256;
+
+    AssetTable() : slotCount(0) {}
+
+    ~AssetTable() {
+        for (int i = 0; i < slotCount; ++i) delete slots[i].asset;
+    }
+
+    // The cached entry for path, created empty if there is none yet.
+    AssetHandle<T> acquire(const std::string& path) {
+        int freeSlot = -1;
+        for (int i = 0; i < slotCount; ++i) {
+            if (!slots[i].asset) {
+                if (freeSlot < 0) freeSlot = i;
+            }
+            else if (slots[i].path == path) {
+                return AssetHandle<T>(this, i);
+            }
+        }
+        if (freeSlot < 0) {
+            if (slotCount >= MAX_ASSETS) {
+                LOG_ERROR("ASSET ERROR: Cache full, cannot add %s", path.c_str());
+                return AssetHandle<T>();
+            }
+            freeSlot = slotCount++;
+        }
+        Slot& entry = slots[freeSlot];
+        entry.path = path;
+        entry.asset = new T();
+        entry.refs = 0;
+        entry.loaded = false;
+        return AssetHandle<T>(this, freeSlot);
+    }
+
+    AssetHandle<T> load(const std::string& path) {
+        AssetHandle<T> handle = acquire(path);
+        handle.load();
+        return handle;
+    }
+
+    // Frees every asset no handle refers to; returns how many went.
+    int evictUnused() {
+        int evicted = 0;
+        for (int i = 0; i < slotCount; ++i) {
+            if (slots[i].asset && slots[i].refs == 0) {
+                delete slots[i].asset;
+                slots[i].asset = nullptr;
+                slots[i].path.clear();
+                slots[i].loaded = false;
+                evicted++;
+            }
+        }
+        return evicted;
+    }
+
+    int getResidentCount() const {
+        int resident = 0;
+        for (int i = 0; i < slotCount; ++i) {
+            if (slots[i].asset) resident++;
+        }
+        return resident;
+    }
+
+    // Walks the loaded assets, for totals over the whole table.
+    int getSlotCount() const { return slotCount; }
+    const T* getLoaded(int slot) const { return slots[slot].loaded ? slots[slot].asset : nullptr; }
+
+private:
+    friend class AssetHandle<T>;
+
+    struct Slot {
+        std::string path;
+        T* asset; // nullptr while the slot is free
+        int refs;
+        bool loaded;
+    };
+
+    Slot slots[MAX_ASSETS];
+    int slotCount;
+
+    AssetTable(const AssetTable&) = delete;
+    AssetTable& operator=(const AssetTable&) = delete;
+};
+
+typedef AssetHandle<sf::Texture> TextureHandle;
+typedef AssetHandle<sf::Font> FontHandle;
+typedef AssetHandle<sf::SoundBuffer> SoundBufferHandle;
+
+// Every texture, font and sound buffer the game loads by path, each loaded
+// once however many owners ask for it. Anything still in use survives
+// evictUnused(), which Game calls on level change.
+class AssetCache {
+public:
+    TextureHandle texture(const std::string& path) { return textures.load(path); }
+    FontHandle font(const std::string& path) { return fonts.load(path); }
+    SoundBufferHandle soundBuffer(const std::string& path) { return soundBuffers.load(path); }
+
+    // Entries that are not loaded yet, for owners that fill them in later.
+    TextureHandle acquireTexture(const std::string& path) { return textures.acquire(path); }
+    FontHandle acquireFont(const std::string& path) { return fonts.acquire(path); }
+
+    int evictUnused() {
+        return textures.evictUnused() + fonts.evictUnused() + soundBuffers.evictUnused();
+    }
+
+    int getResidentCount() const {
+        return textures.getResidentCount() + fonts.getResidentCount() + soundBuffers.getResidentCount();
+    }
+
+    // Video memory the loaded textures take, at four bytes a pixel.
+    size_t getTextureBytes() const {
+        size_t bytes = 0;
+        for (int i = 0; i < textures.getSlotCount(); ++i) {
+            const sf::Texture* texture = textures.getLoaded(i);
+            if (texture) bytes += static_cast<size_t>(texture->getSize().x) * texture->getSize().y * 4;
+        }
+        return bytes;
+    }
+
+private:
+    AssetTable<sf::Texture> textures;
+    AssetTable<sf::Font> fonts;
+    AssetTable<sf::SoundBuffer> soundBuffers;
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Decodes image files into sf::Image on a small pool of worker threads.
+// Decoding (file I/O and PNG inflate) is the slow part of loading a texture
+// and needs no GL context; the upload to a texture stays on the main thread,
+// which polls getState() and takes the image once it reads Decoded.
+class AssetLoader {
+public:
+    static const int MAX_JOBS = 256;
+    static const int MAX_WORKERS = 4;
+
+    enum JobState { Queued, Decoding, Decoded, Failed };
+
+    AssetLoader() : jobCount(0), nextJob(0), workerCount(0), stopping(false) {}
+
+    ~AssetLoader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (int i = 0; i < workerCount; ++i) workers[i].join();
+    }
+
+    // Queues path for decoding and returns its job id, or -1 if the queue is full.
+    int request(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobCount >= MAX_JOBS) return -1;
+        if (workerCount == 0) startWorkers();
+        jobs[jobCount].path = path;
+        jobs[jobCount].state = Queued;
+        wake.notify_one();
+        return jobCount++;
+    }
+
+    // Blocks until no job is queued or decoding any more.
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (hasPendingJobs()) settled.wait(lock);
+    }
+
+    JobState getState(int job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return jobs[job].state;
+    }
+
+    // Valid once getState(job) returned Decoded; the worker is done with it then.
+    const sf::Image& getImage(int job) const { return jobs[job].image; }
+
+    // Frees a job's pixels once they have been uploaded.
+    void releaseImage(int job) { jobs[job].image = sf::Image(); }
+
+    // Forgets every job once all of them have finished, so the ids can be reused.
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (hasPendingJobs()) return;
+        for (int i = 0; i < jobCount; ++i) jobs[i].image = sf::Image();
+        jobCount = 0;
+        nextJob = 0;
+    }
+
+private:
+    struct Job {
+        std::string path;
+        sf::Image image;
+        JobState state;
+    };
+
+    Job jobs[MAX_JOBS];
+    int jobCount;
+    int nextJob; // first job no worker has claimed yet
+    std::thread workers[MAX_WORKERS];
+    int workerCount;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable settled; // a job finished decoding
+
+    // Caller holds the mutex.
+    bool hasPendingJobs() const {
+        for (int i = 0; i < jobCount; ++i) {
+            if (jobs[i].state == Queued || jobs[i].state == Decoding) return true;
+        }
+        return false;
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Caller holds the mutex. Leaves a core for the main thread's uploads.
+    void startWorkers() {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = cores > 2 ? cores - 1 : 1;
+        if (workerCount > MAX_WORKERS) workerCount = MAX_WORKERS;
+        for (int i = 0; i < workerCount; ++i) workers[i] = std::thread(&AssetLoader::workerLoop, this);
+    }
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            while (!stopping && nextJob >= jobCount) wake.wait(lock);
+            if (stopping) return;
+
+            Job& job = jobs[nextJob++];
+            job.state = Decoding;
+            lock.unlock();
+            bool ok = job.image.loadFromFile(job.path);
+            lock.lock();
+            job.state = ok ? Decoded : Failed;
+            settled.notify_all();
+        }
+    }
+};
@@ -2,6 +2,13 @@
 #include "Animation.h"
 #include "JumpQueue.h"
 #include "PositionQueue.h"
+#include "Input.h"
+#include "Logger.h"
+#include "TileProperties.h"
+#include "TileGrid.h"
+#include "TileSweep.h"
+#include "NavGraph.h"
+#include "PathFinder.h"
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <iostream>
@@ -11,6 +18,9 @@ using namespace std;
 const int SCREEN_X = 1200;
 const int SCREEN_Y = 900;
 const int CELL_SIZE = 64;
+// Length of one simulation step. Movement constants are tuned per step, so the
+// game always advances in steps of exactly this size regardless of frame rate.
+const float FIXED_TIMESTEP = 1.0f / 60.0f;
 
 class Character {
 public:
@@ -24,27 +34,47 @@ public:
     static const int StateCount = 7;
 
     Character(float x, float y, int width, int height, float baseMaxSpeed, float scale = 1.0f)
-        : sprite(), posX(x), posY(y), velX(0.0f), velY(0.0f), onGround(false), scale(scale), facingRight(false),
+        : sprite(), posX(x), posY(y), prevPosX(x), prevPosY(y), velX(0.0f), velY(0.0f), onGround(false), scale(scale), facingRight(false),
         baseMaxSpeed(baseMaxSpeed), currentMaxSpeed(baseMaxSpeed), followerMoveTime(0.0f), isFollowerBoosted(false),
         justJumped(false), jumpedWhileStill(false), jumpedWhileStillThisFrame(false), jumpDelayTimer(0.0f),
-        currentState(Idle), isCollidingLeft(false), isCollidingRight(false)
+        currentState(Idle), isCollidingLeft(false), isCollidingRight(false), stuckTimer(0.0f), lastPosX(x),
+        lastGroundX(x), lastGroundY(y)
     {
         sprite.setScale(scale, scale);
         sprite.setPosition(x, y);
         this->width = width * scale;
         this->height = height * scale;
-        for (int i = 0; i < StateCount; ++i) {
-            leftAnimations[i] = nullptr;
-            rightAnimations[i] = nullptr;
-        }
         sprite.setPosition(x, y);
     }
 
 
-    virtual ~Character() {
+    virtual ~Character() {}
+
+    // Back to the state a newly constructed character starts in, keeping only
+    // where it stands, so a game restarted in the same process simulates like
+    // a fresh one (and like its replay).
+    virtual void resetState() {
+        velX = 0.0f;
+        velY = 0.0f;
+        onGround = false;
+        facingRight = false;
+        currentMaxSpeed = baseMaxSpeed;
+        followerMoveTime = 0.0f;
+        isFollowerBoosted = false;
+        justJumped = false;
+        jumpedWhileStill = false;
+        jumpedWhileStillThisFrame = false;
+        jumpDelayTimer = 0.0f;
+        currentState = Idle;
+        isCollidingLeft = false;
+        isCollidingRight = false;
+        stuckTimer = 0.0f;
+        lastPosX = posX;
+        lastGroundX = posX;
+        lastGroundY = posY;
         for (int i = 0; i < StateCount; ++i) {
-            delete leftAnimations[i];
-            delete rightAnimations[i];
+            leftAnimations[i].reset();
+            rightAnimations[i].reset();
         }
     }
 
@@ -61,21 +91,26 @@ public:
     bool isFacingRight() const { return facingRight; }
 
     void setOnGround(bool value) { onGround = value; }
-    void setPosX(float value) { posX = value; }
-    void setPosY(float value) { posY = value; }
+    // Teleports also move the previous position so the sprite doesn't streak across the screen.
+    void setPosX(float value) { posX = value; prevPosX = value; }
+    void setPosY(float value) { posY = value; prevPosY = value; }
+
+    void storePreviousPosition() { prevPosX = posX; prevPosY = posY; }
+    float getRenderX(float alpha) const { return prevPosX + (posX - prevPosX) * alpha; }
+    float getRenderY(float alpha) const { return prevPosY + (posY - prevPosY) * alpha; }
     void setVelX(float value) { velX = value; }
     void setVelY(float value) { velY = value; }
 
     virtual void update(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime)
+        const TileGrid& level, float deltaTime, const InputState& input)
     {
         justJumped = false;
         jumpedWhileStill = false;
         isCollidingLeft = false;
         isCollidingRight = false;
 
-        bool isMovingLeft = Keyboard::isKeyPressed(Keyboard::Left);
-        bool isMovingRight = Keyboard::isKeyPressed(Keyboard::Right);
+        bool isMovingLeft = input.left;
+        bool isMovingRight = input.right;
         int currentDirection = (isMovingRight ? 1 : (isMovingLeft ? -1 : 0));
 
         if (!onGround) {
@@ -91,7 +126,7 @@ public:
         if (velX > 0) facingRight = true;
         else if (velX < 0) facingRight = false;
 
-        if (Keyboard::isKeyPressed(Keyboard::Up) && onGround) {
+        if (input.up && onGround) {
             velY = jumpStrength;
             onGround = false;
             justJumped = true;
@@ -105,7 +140,7 @@ public:
         else velX = currentDirection * currentMaxSpeed;
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (isCollidingLeft && isMovingLeft && onGround) {
             currentState = Pushing;
@@ -121,13 +156,13 @@ public:
             float centerX = posX + width / 2.0f;
             int centerCol = static_cast<int>(centerX / CELL_SIZE);
 
-            if (centerCol >= 0 && centerCol < cols && botRow >= 0 && botRow < rows) {
-                char currentBlock = level[botRow][centerCol];
-                if (currentBlock == 'f' || currentBlock == 'p') {
+            if (centerCol >= 0 && centerCol < level.getCols() && botRow >= 0 && botRow < level.getRows()) {
+                char currentBlock = level.get(centerCol, botRow);
+                if (tileHas(currentBlock, TILE_EDGE_SUPPORT)) {
                     bool hasLeftNeighbor = (centerCol > 0) &&
-                        (level[botRow][centerCol - 1] == 'f' || level[botRow][centerCol - 1] == 'p');
-                    bool hasRightNeighbor = (centerCol < cols - 1) &&
-                        (level[botRow][centerCol + 1] == 'f' || level[botRow][centerCol + 1] == 'p');
+                        tileHas(level.get(centerCol - 1, botRow), TILE_EDGE_SUPPORT);
+                    bool hasRightNeighbor = (centerCol < level.getCols() - 1) &&
+                        tileHas(level.get(centerCol + 1, botRow), TILE_EDGE_SUPPORT);
 
                     float blockLeftX = centerCol * CELL_SIZE;
                     float blockRightX = (centerCol + 1) * CELL_SIZE;
@@ -153,13 +188,13 @@ public:
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p' || level[row][colLeft] == 'b' || level[row][colLeft] == 'N')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p' || level[row][colRight] == 'b'||level[row][colRight] == 'N')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -168,14 +203,14 @@ public:
         else if (!justJumped) velY = 0.0f;
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
-            rightAnimations[currentState] : leftAnimations[currentState];
+        AnimationState* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
+            &rightAnimations[currentState] : &leftAnimations[currentState];
         if (currentState == Edging) {
-            currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+            currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
         }
-        if (currentAnim) {
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -185,8 +220,8 @@ public:
     }
 
     virtual void updateFollower(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime,
-        float targetX, float targetY, JumpQueue& jumpQueue)
+        const TileGrid& level, const NavGraph& nav, PathFinder& paths, float deltaTime,
+        float targetX, float targetY, JumpQueue& jumpQueue, const InputState& input)
     {
         jumpDelayTimer -= deltaTime;
         justJumped = false;
@@ -240,61 +275,14 @@ public:
         int topRow = int((posY + 5 * scale) / CELL_SIZE);
         int botRow = int((posY + height - 5 * scale) / CELL_SIZE);
 
-        if (velX > 0 && dx > 0) {
-            bool shouldJump = false;
-            for (int offset = 1; offset <= 2; ++offset) {
-                int aheadCol = rightCol + offset;
-                if (aheadCol < cols) {
-                    for (int y = topRow; y <= botRow; ++y) {
-                        if (level[y][aheadCol] == 'w' || level[y][aheadCol] == 'b'|| level[y][aheadCol] == 'N') {
-                            if (onGround && targetX > (aheadCol * CELL_SIZE)) {
-                                shouldJump = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (botRow + 1 < rows && level[botRow + 1][aheadCol] == '.' && onGround) {
-                        if (targetX > (aheadCol * CELL_SIZE)) {
-                            shouldJump = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            if (shouldJump) {
-                velY = jumpStrength * 1.1f; // Increased jump strength for follower
-                onGround = false;
-                justJumped = true;
-                jumpDelayTimer = 0.2f;
-            }
-        }
-        else if (velX < 0 && dx < 0) {
-            bool shouldJump = false;
-            for (int offset = 1; offset <= 2; ++offset) {
-                int aheadCol = leftCol - offset;
-                if (aheadCol >= 0) {
-                    for (int y = topRow; y <= botRow; ++y) {
-                        if (level[y][aheadCol] == 'w' || level[y][aheadCol] == 'b'||level[y][aheadCol] == 'b') {
-                            if (onGround && targetX < (aheadCol * CELL_SIZE)) {
-                                shouldJump = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (botRow + 1 < rows && level[botRow + 1][aheadCol] == '.' && onGround) {
-                        if (targetX < (aheadCol* CELL_SIZE)) {
-                            shouldJump = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            if (shouldJump) {
-                velY = jumpStrength * 1.1f; // Increased jump strength for follower
-                onGround = false;
-                justJumped = true;
-                jumpDelayTimer = 0.2f;
-            }
+        int direction = (velX > 0 && dx > 0) ? 1 : (velX < 0 && dx < 0) ? -1 : 0;
+        int startCol = (direction == 1) ? rightCol : leftCol;
+        if (direction != 0 && onGround && (obstacleAhead(nav, startCol, direction, topRow, botRow, targetX, true) ||
+            pathJumpAhead(level, paths, gravity, jumpStrength * 1.1f, direction, targetX, targetY))) {
+            velY = jumpStrength * 1.1f; // Increased jump strength for follower
+            onGround = false;
+            justJumped = true;
+            jumpDelayTimer = 0.2f;
         }
 
         if (!jumpQueue.isEmpty()) {
@@ -317,7 +305,7 @@ public:
         }
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (isCollidingLeft && targetVelocityX < 0 && onGround) {
             currentState = Pushing;
@@ -333,13 +321,13 @@ public:
             float centerX = posX + width / 2.0f;
             int centerCol = static_cast<int>(centerX / CELL_SIZE);
 
-            if (centerCol >= 0 && centerCol < cols && botRow >= 0 && botRow < rows) {
-                char currentBlock = level[botRow][centerCol];
-                if (currentBlock == 'f' || currentBlock == 'p') {
+            if (centerCol >= 0 && centerCol < level.getCols() && botRow >= 0 && botRow < level.getRows()) {
+                char currentBlock = level.get(centerCol, botRow);
+                if (tileHas(currentBlock, TILE_EDGE_SUPPORT)) {
                     bool hasLeftNeighbor = (centerCol > 0) &&
-                        (level[botRow][centerCol - 1] == 'f' || level[botRow][centerCol - 1] == 'p');
-                    bool hasRightNeighbor = (centerCol < cols - 1) &&
-                        (level[botRow][centerCol + 1] == 'f' || level[botRow][centerCol + 1] == 'p');
+                        tileHas(level.get(centerCol - 1, botRow), TILE_EDGE_SUPPORT);
+                    bool hasRightNeighbor = (centerCol < level.getCols() - 1) &&
+                        tileHas(level.get(centerCol + 1, botRow), TILE_EDGE_SUPPORT);
 
                     float blockLeftX = centerCol * CELL_SIZE;
                     float blockRightX = (centerCol + 1) * CELL_SIZE;
@@ -360,13 +348,13 @@ public:
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -375,14 +363,14 @@ public:
         else if (!justJumped) velY = 0.0f;
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
-            rightAnimations[currentState] : leftAnimations[currentState];
+        AnimationState* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
+            &rightAnimations[currentState] : &leftAnimations[currentState];
         if (currentState == Edging) {
-            currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+            currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
         }
-        if (currentAnim) {
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -391,7 +379,9 @@ public:
         sprite.setPosition(posX, posY);
     }
 
-    virtual void draw(RenderWindow& window, const RenderStates& states = RenderStates::Default) {
+    // alpha is how far the renderer is between the previous and the current simulation step.
+    virtual void draw(RenderWindow& window, const RenderStates& states = RenderStates::Default, float alpha = 1.0f) {
+        sprite.setPosition(getRenderX(alpha), getRenderY(alpha));
         window.draw(sprite, states);
     }
 
@@ -403,10 +393,11 @@ public:
 
 
 protected:
-    
-   
+    friend class GameBench; // bench/Benchmark.cpp times the collision passes directly
+
     Sprite sprite;
     float posX, posY;
+    float prevPosX, prevPosY;
     float velX, velY;
     bool onGround;
     float lastGroundX, lastGroundY;
@@ -416,8 +407,8 @@ protected:
     float baseMaxSpeed;
     float followerMoveTime;
     bool isFollowerBoosted;
-    Animation* leftAnimations[StateCount];
-    Animation* rightAnimations[StateCount];
+    AnimationState leftAnimations[StateCount];
+    AnimationState rightAnimations[StateCount];
     int currentState;
     bool isCollidingLeft;
     bool isCollidingRight;
@@ -427,115 +418,127 @@ protected:
 
 
     virtual bool isBlockSolid(char c) const {
-        return c == 'w' || c == 'b' || c == 'l' || c == 'g' || c == 'N'; // Added 'g' as solid
+        return tileHas(c, TILE_SOLID_SIDE);
     }
 
-    // ...existing code...
-virtual void applyHorizontalCollision(const char** level, int rows, int cols) {
-    if (level == nullptr) return;
-    int leftCol = int((posX + 8 * scale) / CELL_SIZE);
-    int rightCol = int((posX + width - 8 * scale) / CELL_SIZE);
-    int topRow = int((posY + 5 * scale) / CELL_SIZE);
-    int botRow = int((posY + height - 5 * scale) / CELL_SIZE);
-
-    // Left collision
-    if (velX < 0 && leftCol >= 0) {
-        for (int y = topRow; y <= botRow; ++y) {
-            if (y >= 0 && y < rows && leftCol >= 0 && leftCol < cols) {
-                char c = level[y][leftCol];
-                if (isBlockSolid(c)) {
-                    posX = (leftCol + 1) * CELL_SIZE - 8 * scale;
-                    velX = 0;
-                    isCollidingLeft = true;
-                    break;
-                }
-            }
+    // The NavGraph walls that match isBlockSolid().
+    virtual int navWalls() const {
+        return NavGraph::SOLID_WALLS;
+    }
+
+    // Follower lookahead: whether one of the next two columns in direction
+    // holds a wall (or, with drops, a '.' under the feet) the target is past.
+    bool obstacleAhead(const NavGraph& nav, int startCol, int direction, int topRow, int botRow, float targetX, bool drops) const {
+        for (int offset = 1; offset <= 2; ++offset) {
+            int aheadCol = startCol + offset * direction;
+            if (aheadCol < 0 || aheadCol >= nav.getCols()) break;
+            int aheadX = aheadCol * CELL_SIZE;
+            bool beyond = (direction == 1) ? (targetX > aheadX) : (targetX < aheadX);
+            if (!beyond) continue;
+            if (nav.hasWall(aheadCol, topRow, botRow, navWalls())) return true;
+            if (drops && nav.isDrop(aheadCol, botRow + 1)) return true;
         }
+        return false;
     }
 
-    // Right collision
-    if (velX > 0 && rightCol < cols) {
-        for (int y = topRow; y <= botRow; ++y) {
-            if (y >= 0 && y < rows && rightCol >= 0 && rightCol < cols) {
-                char c = level[y][rightCol];
-                if (isBlockSolid(c)) {
-                    posX = rightCol * CELL_SIZE - width + 8 * scale;
-                    velX = 0;
-                    isCollidingRight = true;
-                    break;
-                }
+    // Whether the path to the target, treating the target as the same size as
+    // this character, starts with a jump from here: up onto a ledge, say,
+    // which the lookahead above does not see.
+    bool pathJumpAhead(const TileGrid& level, PathFinder& paths, float gravity, float jumpVelocity,
+        int direction, float targetX, float targetY) const
+    {
+        int bodyRows = static_cast<int>((height + CELL_SIZE - 1) / CELL_SIZE);
+        int jumpRows = static_cast<int>(jumpVelocity * jumpVelocity / (2.0f * gravity) / CELL_SIZE);
+        int fromCol = static_cast<int>((posX + width / 2.0f) / CELL_SIZE);
+        int fromRow = static_cast<int>((posY + height - 1) / CELL_SIZE);
+        int toCol = static_cast<int>((targetX + width / 2.0f) / CELL_SIZE);
+        int toRow = static_cast<int>((targetY + height - 1) / CELL_SIZE);
+        PathFinder::Step step;
+        if (paths.nextStep(level, PathFinder::WALKER, bodyRows, jumpRows, fromCol, fromRow, toCol, toRow, step) != PathFinder::FOUND) return false;
+        return step.jump && (step.x - fromCol) * direction >= 0;
+    }
+
+    // Both passes run right after the move along their axis (posX += velX,
+    // posY += velY) and sweep the leading edge over every cell line it crossed.
+    virtual void applyHorizontalCollision(const TileGrid& level) {
+        if (level.isEmpty()) return;
+        float fromX = posX - velX;
+        int topRow = int((posY + 5 * scale) / CELL_SIZE);
+        int botRow = int((posY + height - 5 * scale) / CELL_SIZE);
+        auto solid = [this](char c) { return isBlockSolid(c); };
+        int hitCol;
+
+        // Left collision
+        if (velX < 0) {
+            int fromCol = int((fromX + 8 * scale) / CELL_SIZE);
+            int leftCol = int((posX + 8 * scale) / CELL_SIZE);
+            if (sweepColumns(level, fromCol, leftCol, topRow, botRow, solid, hitCol)) {
+                posX = (hitCol + 1) * CELL_SIZE - 8 * scale;
+                velX = 0;
+                isCollidingLeft = true;
             }
         }
-    }
-}
 
+        // Right collision
+        if (velX > 0) {
+            int fromCol = int((fromX + width - 8 * scale) / CELL_SIZE);
+            int rightCol = int((posX + width - 8 * scale) / CELL_SIZE);
+            if (sweepColumns(level, fromCol, rightCol, topRow, botRow, solid, hitCol)) {
+                posX = hitCol * CELL_SIZE - width + 8 * scale;
+                velX = 0;
+                isCollidingRight = true;
+            }
+        }
+    }
 
-    void applyVerticalCollision(const char** level, int rows, int cols) {
-        if (level == nullptr) return;
+    void applyVerticalCollision(const TileGrid& level) {
+        if (level.isEmpty()) return;
+        float fromY = posY - velY;
         int leftCol = int((posX + 8 * scale) / CELL_SIZE);
         int rightCol = int((posX + width - 8 * scale) / CELL_SIZE);
-        int botRow = static_cast<int>((posY + height) / CELL_SIZE);
+        int hitRow;
 
-        if (velY > 0 && botRow < rows && !justJumped) {
-            bool anyFloor = false;
-            for (int x = leftCol; x <= rightCol; ++x) {
-                if (x >= 0 && x < cols && botRow < rows) {
-                    char c = level[botRow][x];
-                    if (c == 'f' || c == 'p' || c == 'b' || c == 'l' || c == 'g') {
-                        anyFloor = true;
-                        break;
-                    }
-                }
-            }
-            if (anyFloor) {
-                posY = (botRow * CELL_SIZE) - height;
+        if (velY > 0 && !justJumped) {
+            int fromRow = static_cast<int>((fromY + height) / CELL_SIZE);
+            int botRow = static_cast<int>((posY + height) / CELL_SIZE);
+            if (sweepRows(level, fromRow, botRow, leftCol, rightCol, [](char c) { return tileHas(c, TILE_FLOOR); }, hitRow)) {
+                posY = (hitRow * CELL_SIZE) - height;
                 velY = 0;
                 onGround = true;
             }
-            else onGround = false;
+            else if (botRow < level.getRows()) onGround = false;
         }
-        else if (velY < 0) {
+        else if (velY < 0 && leftCol >= 0 && rightCol < level.getCols()) {
+            int fromRow = static_cast<int>(fromY / CELL_SIZE);
             int topRow = static_cast<int>(posY / CELL_SIZE);
-            if (topRow >= 0 && topRow < rows && leftCol >= 0 && rightCol < cols) {
-                bool hitCeiling = false;
-                for (int x = leftCol; x <= rightCol; ++x) {
-                    if (x >= 0 && x < cols) {
-                        char c = level[topRow][x];
-                        if (c == 'r' || c == 'b' || c == 'l' || c == 'g') {
-                            hitCeiling = true;
-                            break;
-                        }
-                    }
-                }
-                if (hitCeiling) {
-                    posY = (topRow + 1) * CELL_SIZE;
-                    velY = 0;
-                }
+            if (sweepRows(level, fromRow, topRow, leftCol, rightCol, [](char c) { return tileHas(c, TILE_CEILING); }, hitRow)) {
+                posY = (hitRow + 1) * CELL_SIZE;
+                velY = 0;
             }
         }
     }
     void setEdgingAnimation() {
         currentState = Edging;
         if (facingRight) {
-            rightAnimations[Edging]->reset();
+            rightAnimations[Edging].reset();
         }
         else {
-            leftAnimations[Edging]->reset();
+            leftAnimations[Edging].reset();
         }
     }
 
-    bool isOnEdge(const char** level, int rows, int cols)  {
+    bool isOnEdge(const TileGrid& level)  {
         int botRow = static_cast<int>((posY + height) / CELL_SIZE);
         float centerX = posX + width / 2.0f;
         int centerCol = static_cast<int>(centerX / CELL_SIZE);
 
-        if (centerCol >= 0 && centerCol < cols && botRow >= 0 && botRow < rows) {
-            char currentBlock = level[botRow][centerCol];
-            if (currentBlock == 'f' || currentBlock == 'b' || currentBlock == 'p') {
+        if (centerCol >= 0 && centerCol < level.getCols() && botRow >= 0 && botRow < level.getRows()) {
+            char currentBlock = level.get(centerCol, botRow);
+            if (tileHas(currentBlock, TILE_EDGE_SUPPORT)) {
                 bool hasLeftNeighbor = (centerCol > 0) &&
-                    (level[botRow][centerCol - 1] == 'f' || level[botRow][centerCol - 1] == 'b' || level[botRow][centerCol - 1] == 'p');
-                bool hasRightNeighbor = (centerCol < cols - 1) &&
-                    (level[botRow][centerCol + 1] == 'f' || level[botRow][centerCol + 1] == 'b' || level[botRow][centerCol + 1] == 'p');
+                    tileHas(level.get(centerCol - 1, botRow), TILE_EDGE_SUPPORT);
+                bool hasRightNeighbor = (centerCol < level.getCols() - 1) &&
+                    tileHas(level.get(centerCol + 1, botRow), TILE_EDGE_SUPPORT);
                 if (!hasLeftNeighbor) {
                     facingRight = false;
                     return true;
@@ -561,9 +564,9 @@ public:
     Coord blocksToBreak[MAX_BLOCKS_TO_BREAK];
     int numBlocksToBreak;
     Knuckles(float x, float y, int width, int height, float baseMaxSpeed, float scale,
-         Texture& idleLeft,  Texture& idleRight,  Texture& runLeft,  Texture& runRight,
-         Texture& jumpLeft,  Texture& jumpRight,  Texture& pushLeft,  Texture& pushRight,
-         Texture& edgeLeft,  Texture& edgeRight,  Texture& punchLeft,  Texture& punchRight)
+         const SpriteSheet& idleLeft,  const SpriteSheet& idleRight,  const SpriteSheet& runLeft,  const SpriteSheet& runRight,
+         const SpriteSheet& jumpLeft,  const SpriteSheet& jumpRight,  const SpriteSheet& pushLeft,  const SpriteSheet& pushRight,
+         const SpriteSheet& edgeLeft,  const SpriteSheet& edgeRight,  const SpriteSheet& punchLeft,  const SpriteSheet& punchRight)
         : Character(x, y, width, height, baseMaxSpeed, scale),
         moveTime(0.0f), previousDirection(0), isBoosted(false), stuckTimer(0.0f), lastPosX(x), punchTimer(0.0f),
         numBlocksToBreak(0)
@@ -575,39 +578,39 @@ public:
         const float PUNCH_FRAME_DURATION = 0.1f; // For punch animation
 
         // Idle animation (assuming 4 frames in sprite sheet)
-        int idleLeftFrames = idleLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, idleLeftFrames, IDLE_FRAME_DURATION);
-        int idleRightFrames = idleRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, idleRightFrames, IDLE_FRAME_DURATION);
+        int idleLeftFrames = idleLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, idleLeftFrames, IDLE_FRAME_DURATION);
+        int idleRightFrames = idleRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, idleRightFrames, IDLE_FRAME_DURATION);
 
         // Other animations
-        int runLeftFrames = runLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Running] = new Animation(&runLeft, FRAME_WIDTH, FRAME_HEIGHT, runLeftFrames, FRAME_DURATION);
-        int runRightFrames = runRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Running] = new Animation(&runRight, FRAME_WIDTH, FRAME_HEIGHT, runRightFrames, FRAME_DURATION);
-
-        int jumpLeftFrames = jumpLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Jumping] = new Animation(&jumpLeft, FRAME_WIDTH, FRAME_HEIGHT, jumpLeftFrames, FRAME_DURATION);
-        int jumpRightFrames = jumpRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Jumping] = new Animation(&jumpRight, FRAME_WIDTH, FRAME_HEIGHT, jumpRightFrames, FRAME_DURATION);
-
-        int pushLeftFrames = pushLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Pushing] = new Animation(&pushLeft, FRAME_WIDTH, FRAME_HEIGHT, pushLeftFrames, FRAME_DURATION);
-        int pushRightFrames = pushRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Pushing] = new Animation(&pushRight, FRAME_WIDTH, FRAME_HEIGHT, pushRightFrames, FRAME_DURATION);
-
-        int edgeLeftFrames = edgeLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Edging] = new Animation(&edgeLeft, FRAME_WIDTH, FRAME_HEIGHT, edgeLeftFrames, FRAME_DURATION);
-        int edgeRightFrames = edgeRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Edging] = new Animation(&edgeRight, FRAME_WIDTH, FRAME_HEIGHT, edgeRightFrames, FRAME_DURATION);
-
-        int punchLeftFrames = punchLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Punching] = new Animation(&punchLeft, FRAME_WIDTH, FRAME_HEIGHT, punchLeftFrames, PUNCH_FRAME_DURATION);
-        int punchRightFrames = punchRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Punching] = new Animation(&punchRight, FRAME_WIDTH, FRAME_HEIGHT, punchRightFrames, PUNCH_FRAME_DURATION);
-
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        int runLeftFrames = runLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Running] = AnimationState(runLeft, FRAME_WIDTH, FRAME_HEIGHT, runLeftFrames, FRAME_DURATION);
+        int runRightFrames = runRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Running] = AnimationState(runRight, FRAME_WIDTH, FRAME_HEIGHT, runRightFrames, FRAME_DURATION);
+
+        int jumpLeftFrames = jumpLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Jumping] = AnimationState(jumpLeft, FRAME_WIDTH, FRAME_HEIGHT, jumpLeftFrames, FRAME_DURATION);
+        int jumpRightFrames = jumpRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Jumping] = AnimationState(jumpRight, FRAME_WIDTH, FRAME_HEIGHT, jumpRightFrames, FRAME_DURATION);
+
+        int pushLeftFrames = pushLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Pushing] = AnimationState(pushLeft, FRAME_WIDTH, FRAME_HEIGHT, pushLeftFrames, FRAME_DURATION);
+        int pushRightFrames = pushRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Pushing] = AnimationState(pushRight, FRAME_WIDTH, FRAME_HEIGHT, pushRightFrames, FRAME_DURATION);
+
+        int edgeLeftFrames = edgeLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Edging] = AnimationState(edgeLeft, FRAME_WIDTH, FRAME_HEIGHT, edgeLeftFrames, FRAME_DURATION);
+        int edgeRightFrames = edgeRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Edging] = AnimationState(edgeRight, FRAME_WIDTH, FRAME_HEIGHT, edgeRightFrames, FRAME_DURATION);
+
+        int punchLeftFrames = punchLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Punching] = AnimationState(punchLeft, FRAME_WIDTH, FRAME_HEIGHT, punchLeftFrames, PUNCH_FRAME_DURATION);
+        int punchRightFrames = punchRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Punching] = AnimationState(punchRight, FRAME_WIDTH, FRAME_HEIGHT, punchRightFrames, PUNCH_FRAME_DURATION);
+
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
 
         for (int i = 0; i < MAX_BLOCKS_TO_BREAK; ++i) {
             blocksToBreak[i].x = 0;
@@ -617,7 +620,7 @@ public:
 
 
     void update(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime) override
+        const TileGrid& level, float deltaTime, const InputState& input) override
     {
         justJumped = false;
         jumpedWhileStill = false;
@@ -635,8 +638,8 @@ public:
             }
         }
 
-        bool isMovingLeft =  Keyboard::isKeyPressed( Keyboard::Left);
-        bool isMovingRight =  Keyboard::isKeyPressed( Keyboard::Right);
+        bool isMovingLeft = input.left;
+        bool isMovingRight = input.right;
         int currentDirection = (isMovingRight ? 1 : (isMovingLeft ? -1 : 0));
 
         if (currentDirection != 0) {
@@ -668,7 +671,7 @@ public:
         if (velX > 0) facingRight = true;
         else if (velX < 0) facingRight = false;
 
-        if ( Keyboard::isKeyPressed( Keyboard::Up) && onGround) {
+        if (input.up && onGround) {
             velY = jumpStrength;
             onGround = false;
             justJumped = true;
@@ -676,8 +679,8 @@ public:
                 jumpedWhileStill = true;
                 jumpedWhileStillThisFrame = true;
             }
-            leftAnimations[Jumping]->reset();
-            rightAnimations[Jumping]->reset();
+            leftAnimations[Jumping].reset();
+            rightAnimations[Jumping].reset();
             if (currentState == Punching) {
                 currentState = Jumping;
                 punchTimer = 0.0f;
@@ -685,22 +688,22 @@ public:
         }
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (velX != 0 && currentState != Punching) {
             int checkCol = velX > 0 ? static_cast<int>((posX + width) / CELL_SIZE) : static_cast<int>(posX / CELL_SIZE);
             int topRow = static_cast<int>(posY / CELL_SIZE);
             int botRow = static_cast<int>((posY + height) / CELL_SIZE);
             for (int y = topRow; y <= botRow; ++y) {
-                if (y >= 0 && y < rows && checkCol >= 0 && checkCol < cols && level[y][checkCol] == 'l') {
+                if (y >= 0 && y < level.getRows() && tileHas(level.get(checkCol, y), TILE_BREAKABLE)) {
                     if (numBlocksToBreak < MAX_BLOCKS_TO_BREAK) {
                         blocksToBreak[numBlocksToBreak].x = checkCol;
                         blocksToBreak[numBlocksToBreak].y = y;
                         numBlocksToBreak++;
                         currentState = Punching;
                         punchTimer = 0.3f;
-                        leftAnimations[Punching]->reset();
-                        rightAnimations[Punching]->reset();
+                        leftAnimations[Punching].reset();
+                        rightAnimations[Punching].reset();
                         velX = 0.0f; // Set velocity to 0 on collision with 'l'
                     }
                     break;
@@ -712,19 +715,19 @@ public:
             if (isCollidingLeft && isMovingLeft && onGround) {
                 currentState = Pushing;
                 facingRight = false;
-                leftAnimations[Pushing]->reset();
+                leftAnimations[Pushing].reset();
             }
             else if (isCollidingRight && isMovingRight && onGround) {
                 currentState = Pushing;
                 facingRight = true;
-                rightAnimations[Pushing]->reset();
+                rightAnimations[Pushing].reset();
             }
-            else if (currentState == Idle && onGround && isOnEdge(level, rows, cols)) {
+            else if (currentState == Idle && onGround && isOnEdge(level)) {
                 setEdgingAnimation();
             }
         }
 
-        if (currentState == Idle && onGround && isOnEdge(level, rows, cols)) {
+        if (currentState == Idle && onGround && isOnEdge(level)) {
             setEdgingAnimation();
         }
 
@@ -735,13 +738,13 @@ public:
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p' || level[row][colLeft] == 'b')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p' || level[row][colRight] == 'b')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -750,22 +753,22 @@ public:
         else if (!justJumped) velY = 0.0f;
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = nullptr;
+        AnimationState* currentAnim = nullptr;
         if (currentState == Jumping) {
-            currentAnim = facingRight ? rightAnimations[Jumping] : leftAnimations[Jumping];
+            currentAnim = facingRight ? &rightAnimations[Jumping] : &leftAnimations[Jumping];
         }
         else if (currentState == Edging) {
-            currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+            currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
         }
         else if (currentState == Punching) {
-            currentAnim = facingRight ? rightAnimations[Punching] : leftAnimations[Punching];
+            currentAnim = facingRight ? &rightAnimations[Punching] : &leftAnimations[Punching];
         }
         else {
-            currentAnim = facingRight ? rightAnimations[currentState] : leftAnimations[currentState];
+            currentAnim = facingRight ? &rightAnimations[currentState] : &leftAnimations[currentState];
         }
-        if (currentAnim) {
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -775,12 +778,16 @@ public:
 
 
     bool isBlockSolid(char c) const override {
-        return c == 'w' || c == 'b' || c == 'g' || c == 'N'; // 'l' is not solid, but 'g' is
+        return tileHas(c, TILE_SOLID_SIDE) && !tileHas(c, TILE_BREAKABLE); // punches through breakable blocks
+    }
+
+    int navWalls() const override {
+        return NavGraph::UNBREAKABLE_WALLS;
     }
 
     void updateFollower(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime,
-        float targetX, float targetY, JumpQueue& jumpQueue) override
+        const TileGrid& level, const NavGraph& nav, PathFinder& paths, float deltaTime,
+        float targetX, float targetY, JumpQueue& jumpQueue, const InputState& input) override
     {
         jumpDelayTimer -= deltaTime;
         justJumped = false;
@@ -811,31 +818,31 @@ public:
         }
 
         velX += (targetVelocityX - velX) * 0.5f;
-        if (isOnEdge(level, rows, cols)) {
+        if (isOnEdge(level)) {
 			if (currentState != Edging) {
-				leftAnimations[Edging]->reset();
-				rightAnimations[Edging]->reset();
+				leftAnimations[Edging].reset();
+				rightAnimations[Edging].reset();
 			}
 			currentState = Edging;
 		}
         if (!onGround) {
             if (currentState != Jumping) {
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
+                leftAnimations[Jumping].reset();
+                rightAnimations[Jumping].reset();
             }
             currentState = Jumping;
         }
         else if (abs(velX) > 0.1f) {
             if (currentState != Running) {
-                leftAnimations[Running]->reset();
-                rightAnimations[Running]->reset();
+                leftAnimations[Running].reset();
+                rightAnimations[Running].reset();
             }
             currentState = Running;
         }
         else {
             if (currentState != Idle) {
-                leftAnimations[Idle]->reset();
-                rightAnimations[Idle]->reset();
+                leftAnimations[Idle].reset();
+                rightAnimations[Idle].reset();
             }
             currentState = Idle;
         }
@@ -851,31 +858,18 @@ public:
         int direction = (velX > 0 && dx > 0) ? 1 : (velX < 0 && dx < 0) ? -1 : 0;
 
         if (direction != 0 && onGround) {
-            bool shouldJump = false;
             int startCol = (direction == 1) ? rightCol : leftCol;
-
-            for (int offset = 1; offset <= 2 && !shouldJump; ++offset) {
-                int aheadCol = startCol + offset * direction;
-                if (aheadCol < 0 || aheadCol >= cols) break;
-                for (int y = topRow; y <= botRow; ++y) {
-                    char t = level[y][aheadCol];
-                    if (t == 'w' || t == 'b' || t == 'l' || t == 'N') {
-                        int obsX = aheadCol * CELL_SIZE;
-                        bool beyond = (direction == 1) ? (targetX > obsX) : (targetX < obsX);
-                        if (beyond) shouldJump = true;
-                        break;
-                    }
-                }
-            }
+            bool shouldJump = obstacleAhead(nav, startCol, direction, topRow, botRow, targetX, false);
 
             int detectedGap = 0;
             if (!shouldJump) {
-                detectedGap = detectGap(level, rows, cols, botRow, startCol, direction, targetX,targetY);
+                detectedGap = nav.gapWidth(startCol + direction, botRow, direction);
                 if (detectedGap > 0) {
-                     cout << "Gap detected: " << detectedGap <<  endl;
+                    LOG_DEBUG("Gap detected: %d", detectedGap);
                     shouldJump = true;
                 }
             }
+            if (!shouldJump) shouldJump = pathJumpAhead(level, paths, gravity, jumpStrength * 1.1f, direction, targetX, targetY);
 
             if (shouldJump) {
                 float jumpMultiplier = 1.0f + detectedGap * 1.5f;
@@ -884,8 +878,8 @@ public:
                 onGround = false;
                 justJumped = true;
                 jumpDelayTimer = 0.0f;
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
+                leftAnimations[Jumping].reset();
+                rightAnimations[Jumping].reset();
             }
         }
 
@@ -903,8 +897,8 @@ public:
                 onGround = false;
                 justJumped = true;
                 jumpQueue.dequeue();
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
+                leftAnimations[Jumping].reset();
+                rightAnimations[Jumping].reset();
             }
         }
 
@@ -920,20 +914,20 @@ public:
         }
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (velX != 0 && currentState != Punching) {
             int checkCol = velX > 0 ? rightCol : leftCol;
             for (int y = topRow; y <= botRow; ++y) {
-                if (y >= 0 && y < rows && checkCol >= 0 && checkCol < cols && level[y][checkCol] == 'l') {
+                if (y >= 0 && y < level.getRows() && tileHas(level.get(checkCol, y), TILE_BREAKABLE)) {
                     if (numBlocksToBreak < MAX_BLOCKS_TO_BREAK) {
                         blocksToBreak[numBlocksToBreak].x = checkCol;
                         blocksToBreak[numBlocksToBreak].y = y;
                         numBlocksToBreak++;
                         currentState = Punching;
                         punchTimer = 0.3f;
-                        leftAnimations[Punching]->reset();
-                        rightAnimations[Punching]->reset();
+                        leftAnimations[Punching].reset();
+                        rightAnimations[Punching].reset();
                         velX = 0.0f; // Set velocity to 0 on collision with 'l'
                     }
                     break;
@@ -944,15 +938,15 @@ public:
         if (isCollidingLeft && targetVelocityX < 0 && onGround) {
             currentState = Pushing;
             facingRight = false;
-            leftAnimations[Pushing]->reset();
+            leftAnimations[Pushing].reset();
         }
         else if (isCollidingRight && targetVelocityX > 0 && onGround) {
             currentState = Pushing;
             facingRight = true;
-            rightAnimations[Pushing]->reset();
+            rightAnimations[Pushing].reset();
         }
 
-        if ( isOnEdge(level, rows, cols)) {
+        if ( isOnEdge(level)) {
             setEdgingAnimation();
         }
 
@@ -963,13 +957,13 @@ public:
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p' || level[row][colLeft] == 'b' || level[row][colLeft] == 'l')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p' || level[row][colRight] == 'b' || level[row][colRight] == 'l')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -978,17 +972,17 @@ public:
         else if (!justJumped) velY = 0.0f;
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = (facingRight && currentState != Jumping && currentState != Edging && currentState != Punching) ?
-            rightAnimations[currentState] : leftAnimations[currentState];
+        AnimationState* currentAnim = (facingRight && currentState != Jumping && currentState != Edging && currentState != Punching) ?
+            &rightAnimations[currentState] : &leftAnimations[currentState];
         if (currentState == Edging) {
-            currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+            currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
         }
         else if (currentState == Punching) {
-            currentAnim = facingRight ? rightAnimations[Punching] : leftAnimations[Punching];
+            currentAnim = facingRight ? &rightAnimations[Punching] : &leftAnimations[Punching];
         }
-        if (currentAnim) {
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -997,6 +991,17 @@ public:
         sprite.setPosition(posX, posY);
     }
 
+    void resetState() override {
+        Character::resetState();
+        moveTime = 0.0f;
+        previousDirection = 0;
+        isBoosted = false;
+        stuckTimer = 0.0f;
+        lastPosX = posX;
+        punchTimer = 0.0f;
+        numBlocksToBreak = 0;
+    }
+
 private:
     float moveTime;
     int previousDirection;
@@ -1004,41 +1009,6 @@ private:
     float stuckTimer;
     float lastPosX;
     float punchTimer;
-
-
-    int detectGap(const char** level, int rows, int cols, int botRow, int startCol, int direction, float targetX, float targetY) {
-        if (botRow >= rows) return 0;
-
-        int maxCheck = 6; // Extended range to 6 blocks
-        int gapWidth = 0;
-        int targetRow = static_cast<int>(targetY / CELL_SIZE);
-
-        for (int offset = 1; offset <= maxCheck; ++offset) {
-            int checkCol = startCol + offset * direction;
-            if (checkCol < 0 || checkCol >= cols) break;
-
-            // Check ground level
-            if (botRow < rows && level[botRow][checkCol] == ' ') {
-                gapWidth++;
-            }
-            else {
-                // Found landing spot, check height difference
-                int landRow = botRow;
-                while (landRow < rows && level[landRow][checkCol] == ' ') landRow++;
-                if (landRow < rows && (level[landRow][checkCol] == 'f' || level[landRow][checkCol] == 'b' || level[landRow][checkCol] == 'p' || level[landRow][checkCol] == 'l')) {
-                    float landX = checkCol * CELL_SIZE;
-                    bool beyond = (direction == 1) ? (targetX > landX) : (targetX < landX);
-                    int heightDiff = abs(botRow - landRow) * CELL_SIZE;
-                    if (beyond && heightDiff <= CELL_SIZE * 3) { // Max jump height of 3 blocks
-                        return gapWidth;
-                        cout << "GAP";
-                    }
-                }
-                break;
-            }
-        }
-        return gapWidth > 0 ? gapWidth : 0;
-    }
 };
 
 
@@ -1047,8 +1017,8 @@ private:
 class Sonic : public Character {
 public:
     Sonic(float x, float y, int width, int height, float baseMaxSpeed, float scale,
-        Texture& idleLeft, Texture& idleRight, Texture& runLeft, Texture& runRight,
-        Texture& jump, Texture& pushLeft, Texture& pushRight, Texture& edgeLeft, Texture& edgeRight)
+        const SpriteSheet& idleLeft, const SpriteSheet& idleRight, const SpriteSheet& runLeft, const SpriteSheet& runRight,
+        const SpriteSheet& jump, const SpriteSheet& pushLeft, const SpriteSheet& pushRight, const SpriteSheet& edgeLeft, const SpriteSheet& edgeRight)
         : Character(x, y, width, height, baseMaxSpeed, scale),
         moveTime(0.0f), previousDirection(0), isBoosted(false)
     {
@@ -1056,44 +1026,44 @@ public:
         const int FRAME_HEIGHT = 40;
         const float FRAME_DURATION = 0.05f;
 
-        int idleLeftFrames = idleLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, idleLeftFrames, FRAME_DURATION);
-        int idleRightFrames = idleRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, idleRightFrames, FRAME_DURATION);
+        int idleLeftFrames = idleLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, idleLeftFrames, FRAME_DURATION);
+        int idleRightFrames = idleRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, idleRightFrames, FRAME_DURATION);
 
-        int runLeftFrames = runLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Running] = new Animation(&runLeft, FRAME_WIDTH, FRAME_HEIGHT, runLeftFrames, FRAME_DURATION);
-        int runRightFrames = runRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Running] = new Animation(&runRight, FRAME_WIDTH, FRAME_HEIGHT, runRightFrames, FRAME_DURATION);
+        int runLeftFrames = runLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Running] = AnimationState(runLeft, FRAME_WIDTH, FRAME_HEIGHT, runLeftFrames, FRAME_DURATION);
+        int runRightFrames = runRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Running] = AnimationState(runRight, FRAME_WIDTH, FRAME_HEIGHT, runRightFrames, FRAME_DURATION);
 
-        int jumpFrames = jump.getSize().x / FRAME_WIDTH;
-        leftAnimations[Jumping] = new Animation(&jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
-        rightAnimations[Jumping] = new Animation(&jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
+        int jumpFrames = jump.rect.width / FRAME_WIDTH;
+        leftAnimations[Jumping] = AnimationState(jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
+        rightAnimations[Jumping] = AnimationState(jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
 
-        int pushLeftFrames = pushLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Pushing] = new Animation(&pushLeft, FRAME_WIDTH, FRAME_HEIGHT, pushLeftFrames, FRAME_DURATION);
-        int pushRightFrames = pushRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Pushing] = new Animation(&pushRight, FRAME_WIDTH, FRAME_HEIGHT, pushRightFrames, FRAME_DURATION);
+        int pushLeftFrames = pushLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Pushing] = AnimationState(pushLeft, FRAME_WIDTH, FRAME_HEIGHT, pushLeftFrames, FRAME_DURATION);
+        int pushRightFrames = pushRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Pushing] = AnimationState(pushRight, FRAME_WIDTH, FRAME_HEIGHT, pushRightFrames, FRAME_DURATION);
 
-       int edgeLeftFrames = edgeLeft.getSize().x / FRAME_WIDTH;
-    leftAnimations[Edging] = new Animation(&edgeLeft, FRAME_WIDTH, FRAME_HEIGHT, edgeLeftFrames, FRAME_DURATION);
-    int edgeRightFrames = edgeRight.getSize().x / FRAME_WIDTH;
-    rightAnimations[Edging] = new Animation(&edgeRight, FRAME_WIDTH, FRAME_HEIGHT, edgeRightFrames, FRAME_DURATION);
+       int edgeLeftFrames = edgeLeft.rect.width / FRAME_WIDTH;
+    leftAnimations[Edging] = AnimationState(edgeLeft, FRAME_WIDTH, FRAME_HEIGHT, edgeLeftFrames, FRAME_DURATION);
+    int edgeRightFrames = edgeRight.rect.width / FRAME_WIDTH;
+    rightAnimations[Edging] = AnimationState(edgeRight, FRAME_WIDTH, FRAME_HEIGHT, edgeRightFrames, FRAME_DURATION);
 
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
     }
 
     void update(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime) override
+        const TileGrid& level, float deltaTime, const InputState& input) override
     {
         justJumped = false;
         jumpedWhileStill = false;
         isCollidingLeft = false;
         isCollidingRight = false;
 
-        bool isMovingLeft = Keyboard::isKeyPressed(Keyboard::Left);
-        bool isMovingRight = Keyboard::isKeyPressed(Keyboard::Right);
+        bool isMovingLeft = input.left;
+        bool isMovingRight = input.right;
         int currentDirection = (isMovingRight ? 1 : (isMovingLeft ? -1 : 0));
 
         if (currentDirection != 0) {
@@ -1120,26 +1090,26 @@ public:
 
         if (!onGround) {
             if (currentState != Jumping) {
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
+                leftAnimations[Jumping].reset();
+                rightAnimations[Jumping].reset();
             }
             currentState = Jumping;
         }
         else if (currentDirection != 0) {
             if (currentState != Running) {
-                leftAnimations[Running]->reset();
-                rightAnimations[Running]->reset();
+                leftAnimations[Running].reset();
+                rightAnimations[Running].reset();
             }
             currentState = Running;
         }
-        else if (currentState == Idle && onGround && isOnEdge(level, rows, cols)) {
+        else if (currentState == Idle && onGround && isOnEdge(level)) {
             setEdgingAnimation();
             
         }
         else {
             if (currentState != Idle) {
-                leftAnimations[Idle]->reset();
-                rightAnimations[Idle]->reset();
+                leftAnimations[Idle].reset();
+                rightAnimations[Idle].reset();
             }
             currentState = Idle;
         }
@@ -1147,7 +1117,7 @@ public:
         if (velX > 0) facingRight = true;
         else if (velX < 0) facingRight = false;
 
-        if (Keyboard::isKeyPressed(Keyboard::Up) && onGround) {
+        if (input.up && onGround) {
             velY = jumpStrength;
             onGround = false;
             justJumped = true;
@@ -1155,26 +1125,26 @@ public:
                 jumpedWhileStill = true;
                 jumpedWhileStillThisFrame = true;
             }
-            leftAnimations[Jumping]->reset();
-            rightAnimations[Jumping]->reset();
+            leftAnimations[Jumping].reset();
+            rightAnimations[Jumping].reset();
         }
 
-        if (currentState == Idle && isOnEdge(level, rows, cols)) {
+        if (currentState == Idle && isOnEdge(level)) {
             setEdgingAnimation();
         }
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (isCollidingLeft && isMovingLeft && onGround) {
             currentState = Pushing;
             facingRight = false;
-            leftAnimations[Pushing]->reset();
+            leftAnimations[Pushing].reset();
         }
         else if (isCollidingRight && isMovingRight && onGround) {
             currentState = Pushing;
             facingRight = true;
-            rightAnimations[Pushing]->reset();
+            rightAnimations[Pushing].reset();
         }
 
         float groundCheckOffset = 32.0f * scale;
@@ -1184,13 +1154,13 @@ public:
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p' || level[row][colLeft] == 'b')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p' || level[row][colRight] == 'b')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -1199,14 +1169,14 @@ public:
         else if (!justJumped) velY = 0.0f;
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
-    rightAnimations[currentState] : leftAnimations[currentState];
+        AnimationState* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
+    &rightAnimations[currentState] : &leftAnimations[currentState];
 if (currentState == Edging) {
-    currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+    currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
 }
-if (currentAnim) {
+if (currentAnim && currentAnim->isValid()) {
     currentAnim->update(deltaTime);
     sprite.setTexture(*currentAnim->getTexture());
     sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -1216,8 +1186,8 @@ if (currentAnim) {
 
 
     void updateFollower(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime,
-        float targetX, float targetY, JumpQueue& jumpQueue) override
+        const TileGrid& level, const NavGraph& nav, PathFinder& paths, float deltaTime,
+        float targetX, float targetY, JumpQueue& jumpQueue, const InputState& input) override
     {
         jumpDelayTimer -= deltaTime;
         justJumped = false;
@@ -1239,27 +1209,27 @@ if (currentAnim) {
         }
 
         velX += (targetVelocityX - velX) * 0.1f;
-        if (isOnEdge(level, rows, cols)) {
+        if (isOnEdge(level)) {
 			setEdgingAnimation();
         }
         if (!onGround) {
             if (currentState != Jumping) {
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
+                leftAnimations[Jumping].reset();
+                rightAnimations[Jumping].reset();
             }
             currentState = Jumping;
         }
         else if (abs(velX) > 0.1f) {
             if (currentState != Running) {
-                leftAnimations[Running]->reset();
-                rightAnimations[Running]->reset();
+                leftAnimations[Running].reset();
+                rightAnimations[Running].reset();
             }
             currentState = Running;
         }
         else {
             if (currentState != Idle) {
-                leftAnimations[Idle]->reset();
-                rightAnimations[Idle]->reset();
+                leftAnimations[Idle].reset();
+                rightAnimations[Idle].reset();
             }
             currentState = Idle;
         }
@@ -1272,65 +1242,16 @@ if (currentAnim) {
         int topRow = int((posY + 5 * scale) / CELL_SIZE);
         int botRow = int((posY + height - 5 * scale) / CELL_SIZE);
 
-        if (velX > 0 && dx > 0) {
-            bool shouldJump = false;
-            for (int offset = 1; offset <= 2; ++offset) {
-                int aheadCol = rightCol + offset;
-                if (aheadCol < cols) {
-                    for (int y = topRow; y <= botRow; ++y) {
-                        if (level[y][aheadCol] == 'w' || level[y][aheadCol] == 'b') {
-                            if (onGround && targetX > (aheadCol * CELL_SIZE)) {
-                                shouldJump = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (botRow + 1 < rows && level[botRow + 1][aheadCol] == '.' && onGround) {
-                        if (targetX > (aheadCol * CELL_SIZE)) {
-                            shouldJump = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            if (shouldJump) {
-                velY = jumpStrength * 1.1f; // Increased jump strength for follower
-                onGround = false;
-                justJumped = true;
-                jumpDelayTimer = 0.2f;
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
-            }
-        }
-        else if (velX < 0 && dx < 0) {
-            bool shouldJump = false;
-            for (int offset = 1; offset <= 2; ++offset) {
-                int aheadCol = leftCol - offset;
-                if (aheadCol >= 0) {
-                    for (int y = topRow; y <= botRow; ++y) {
-                        if (level[y][aheadCol] == 'w' || level[y][aheadCol] == 'b'||level[y][aheadCol] == 'N') {
-                            if (onGround && targetX < (aheadCol * CELL_SIZE)) {
-                                shouldJump = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (botRow + 1 < rows && level[botRow + 1][aheadCol] == '.' && onGround) {
-                        if (targetX < (aheadCol* CELL_SIZE)) {
-                            shouldJump = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            if (shouldJump) {
-                velY = jumpStrength * 1.1f; // Increased jump strength for follower
-                onGround = false;
-                justJumped = true;
-                jumpDelayTimer = 0.2f;
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
-            }
+        int direction = (velX > 0 && dx > 0) ? 1 : (velX < 0 && dx < 0) ? -1 : 0;
+        int startCol = (direction == 1) ? rightCol : leftCol;
+        if (direction != 0 && onGround && (obstacleAhead(nav, startCol, direction, topRow, botRow, targetX, true) ||
+            pathJumpAhead(level, paths, gravity, jumpStrength * 1.1f, direction, targetX, targetY))) {
+            velY = jumpStrength * 1.1f; // Increased jump strength for follower
+            onGround = false;
+            justJumped = true;
+            jumpDelayTimer = 0.2f;
+            leftAnimations[Jumping].reset();
+            rightAnimations[Jumping].reset();
         }
 
         if (!jumpQueue.isEmpty()) {
@@ -1349,26 +1270,26 @@ if (currentAnim) {
                 onGround = false;
                 justJumped = true;
                 jumpQueue.dequeue();
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
+                leftAnimations[Jumping].reset();
+                rightAnimations[Jumping].reset();
             }
         }
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (isCollidingLeft && targetVelocityX < 0 && onGround) {
             currentState = Pushing;
             facingRight = false;
-            leftAnimations[Pushing]->reset();
+            leftAnimations[Pushing].reset();
         }
         else if (isCollidingRight && targetVelocityX > 0 && onGround) {
             currentState = Pushing;
             facingRight = true;
-            rightAnimations[Pushing]->reset();
+            rightAnimations[Pushing].reset();
         }
 
-        if (currentState == Idle && onGround && isOnEdge(level, rows, cols)) {
+        if (currentState == Idle && onGround && isOnEdge(level)) {
             setEdgingAnimation();
         }
 
@@ -1379,13 +1300,13 @@ if (currentAnim) {
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p' || level[row][colLeft] == 'b')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p' || level[row][colRight] == 'b')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -1394,14 +1315,14 @@ if (currentAnim) {
         else if (!justJumped) velY = 0.0f;
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
-            rightAnimations[currentState] : leftAnimations[currentState];
+        AnimationState* currentAnim = (facingRight && currentState != Jumping && currentState != Edging) ?
+            &rightAnimations[currentState] : &leftAnimations[currentState];
         if (currentState == Edging) {
-            currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+            currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
         }
-        if (currentAnim) {
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -1410,6 +1331,13 @@ if (currentAnim) {
         sprite.setPosition(posX, posY);
     }
 
+    void resetState() override {
+        Character::resetState();
+        moveTime = 0.0f;
+        previousDirection = 0;
+        isBoosted = false;
+    }
+
 private:
     float moveTime;
     int previousDirection;
@@ -1420,8 +1348,8 @@ private:
 class Tails : public Character {
 public:
     Tails(float x, float y, int width, int height, float baseMaxSpeed, float scale,
-         Texture& idleLeft,  Texture& idleRight,  Texture& runLeft,  Texture& runRight,
-         Texture& jump,  Texture& pushLeft,  Texture& pushRight,  Texture& edgeLeft,  Texture& edgeRight,  Texture& flyLeft,  Texture& flyRight)
+         const SpriteSheet& idleLeft,  const SpriteSheet& idleRight,  const SpriteSheet& runLeft,  const SpriteSheet& runRight,
+         const SpriteSheet& jump,  const SpriteSheet& pushLeft,  const SpriteSheet& pushRight,  const SpriteSheet& edgeLeft,  const SpriteSheet& edgeRight,  const SpriteSheet& flyLeft,  const SpriteSheet& flyRight)
         : Character(x, y, width, height, baseMaxSpeed, scale), flyTimer(0.0f),
         isFlying(false), flyTime(0.0f), cooldownTime(0.0f), maxFlyTime(7.0f), maxCooldownTime(20.0f),
         moveTime(0.0f), previousDirection(0), isBoosted(false), stuckTimer(0.0f), lastPosX(x)
@@ -1432,56 +1360,56 @@ public:
         const float IDLE_FRAME_DURATION = 0.2f;
         const float FLY_FRAME_DURATION = 0.08f;
 
-        int idleLeftFrames = idleLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, idleLeftFrames, IDLE_FRAME_DURATION);
-        int idleRightFrames = idleRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, idleRightFrames, IDLE_FRAME_DURATION);
-
-        int runLeftFrames = runLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Running] = new Animation(&runLeft, FRAME_WIDTH, FRAME_HEIGHT, runLeftFrames, FRAME_DURATION);
-        int runRightFrames = runRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Running] = new Animation(&runRight, FRAME_WIDTH, FRAME_HEIGHT, runRightFrames, FRAME_DURATION);
-
-        int jumpFrames = jump.getSize().x / FRAME_WIDTH;
-        leftAnimations[Jumping] = new Animation(&jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
-        rightAnimations[Jumping] = new Animation(&jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
-
-        int pushLeftFrames = pushLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Pushing] = new Animation(&pushLeft, FRAME_WIDTH, FRAME_HEIGHT, pushLeftFrames, FRAME_DURATION);
-        int pushRightFrames = pushRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Pushing] = new Animation(&pushRight, FRAME_WIDTH, FRAME_HEIGHT, pushRightFrames, FRAME_DURATION);
-
-        int flyLeftFrames = flyLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Flying] = new Animation(&flyLeft, FRAME_WIDTH, FRAME_HEIGHT, flyLeftFrames, FLY_FRAME_DURATION);
-        int flyRightFrames = flyRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Flying] = new Animation(&flyRight, FRAME_WIDTH, FRAME_HEIGHT, flyRightFrames, FLY_FRAME_DURATION);
-
-        int edgeLeftFrames = edgeLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Edging] = new Animation(&edgeLeft, FRAME_WIDTH, FRAME_HEIGHT, edgeLeftFrames, FRAME_DURATION);
-        int edgeRightFrames = edgeRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Edging] = new Animation(&edgeRight, FRAME_WIDTH, FRAME_HEIGHT, edgeRightFrames, FRAME_DURATION);
-
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        int idleLeftFrames = idleLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, idleLeftFrames, IDLE_FRAME_DURATION);
+        int idleRightFrames = idleRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, idleRightFrames, IDLE_FRAME_DURATION);
+
+        int runLeftFrames = runLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Running] = AnimationState(runLeft, FRAME_WIDTH, FRAME_HEIGHT, runLeftFrames, FRAME_DURATION);
+        int runRightFrames = runRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Running] = AnimationState(runRight, FRAME_WIDTH, FRAME_HEIGHT, runRightFrames, FRAME_DURATION);
+
+        int jumpFrames = jump.rect.width / FRAME_WIDTH;
+        leftAnimations[Jumping] = AnimationState(jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
+        rightAnimations[Jumping] = AnimationState(jump, FRAME_WIDTH, FRAME_HEIGHT, jumpFrames, FRAME_DURATION);
+
+        int pushLeftFrames = pushLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Pushing] = AnimationState(pushLeft, FRAME_WIDTH, FRAME_HEIGHT, pushLeftFrames, FRAME_DURATION);
+        int pushRightFrames = pushRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Pushing] = AnimationState(pushRight, FRAME_WIDTH, FRAME_HEIGHT, pushRightFrames, FRAME_DURATION);
+
+        int flyLeftFrames = flyLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Flying] = AnimationState(flyLeft, FRAME_WIDTH, FRAME_HEIGHT, flyLeftFrames, FLY_FRAME_DURATION);
+        int flyRightFrames = flyRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Flying] = AnimationState(flyRight, FRAME_WIDTH, FRAME_HEIGHT, flyRightFrames, FLY_FRAME_DURATION);
+
+        int edgeLeftFrames = edgeLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Edging] = AnimationState(edgeLeft, FRAME_WIDTH, FRAME_HEIGHT, edgeLeftFrames, FRAME_DURATION);
+        int edgeRightFrames = edgeRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Edging] = AnimationState(edgeRight, FRAME_WIDTH, FRAME_HEIGHT, edgeRightFrames, FRAME_DURATION);
+
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
     }
     void update(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime) override
+        const TileGrid& level, float deltaTime, const InputState& input) override
     {
         justJumped = false;
         jumpedWhileStill = false;
         isCollidingLeft = false;
         isCollidingRight = false;
 
-        bool isMovingLeft =  Keyboard::isKeyPressed( Keyboard::Left);
-        bool isMovingRight =  Keyboard::isKeyPressed( Keyboard::Right);
-        bool isFlyingInput =  Keyboard::isKeyPressed( Keyboard::T);
+        bool isMovingLeft = input.left;
+        bool isMovingRight = input.right;
+        bool isFlyingInput = input.fly;
         int currentDirection = (isMovingRight ? 1 : (isMovingLeft ? -1 : 0));
 
         if (isFlyingInput && !isFlying && onGround) {
             isFlying = true;
             flyTimer = maxFlyTime;
-            leftAnimations[Flying]->reset();
-            rightAnimations[Flying]->reset();
+            leftAnimations[Flying].reset();
+            rightAnimations[Flying].reset();
         }
 
         if (isFlying) {
@@ -1502,7 +1430,7 @@ public:
             currentState = Idle;
         }
 
-        if ( Keyboard::isKeyPressed( Keyboard::Up) && onGround && !isFlying) {
+        if (input.up && onGround && !isFlying) {
             velY = jumpStrength;
             onGround = false;
             justJumped = true;
@@ -1510,8 +1438,8 @@ public:
                 jumpedWhileStill = true;
                 jumpedWhileStillThisFrame = true;
             }
-            leftAnimations[Jumping]->reset();
-            rightAnimations[Jumping]->reset();
+            leftAnimations[Jumping].reset();
+            rightAnimations[Jumping].reset();
         }
 
         if (velX > 0) facingRight = true;
@@ -1521,7 +1449,7 @@ public:
         else velX = currentDirection * currentMaxSpeed;
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (isCollidingLeft && isMovingLeft && onGround) {
             currentState = Pushing;
@@ -1532,7 +1460,7 @@ public:
             facingRight = true;
         }
 
-        if (currentState == Idle && onGround && isOnEdge(level, rows, cols)) {
+        if (currentState == Idle && onGround && isOnEdge(level)) {
             setEdgingAnimation();
         }
 
@@ -1543,13 +1471,13 @@ public:
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p' || level[row][colLeft] == 'b')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p' || level[row][colRight] == 'b')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -1560,22 +1488,22 @@ public:
         }
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = nullptr;
+        AnimationState* currentAnim = nullptr;
         if (currentState == Jumping) {
-            currentAnim = facingRight ? rightAnimations[Jumping] : leftAnimations[Jumping];
+            currentAnim = facingRight ? &rightAnimations[Jumping] : &leftAnimations[Jumping];
         }
         else if (currentState == Edging) {
-            currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+            currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
         }
         else if (currentState == Flying) {
-            currentAnim = facingRight ? rightAnimations[Flying] : leftAnimations[Flying];
+            currentAnim = facingRight ? &rightAnimations[Flying] : &leftAnimations[Flying];
         }
         else {
-            currentAnim = facingRight ? rightAnimations[currentState] : leftAnimations[currentState];
+            currentAnim = facingRight ? &rightAnimations[currentState] : &leftAnimations[currentState];
         }
-        if (currentAnim) {
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -1585,20 +1513,20 @@ public:
     }
 
     void updateFollower(float gravity, float terminalVelocity, float jumpStrength,
-        const char** level, int rows, int cols, float deltaTime,
-        float targetX, float targetY, JumpQueue& jumpQueue) override
+        const TileGrid& level, const NavGraph& nav, PathFinder& paths, float deltaTime,
+        float targetX, float targetY, JumpQueue& jumpQueue, const InputState& input) override
     {
         jumpDelayTimer -= deltaTime;
         justJumped = false;
         isCollidingLeft = false;
         isCollidingRight = false;
 
-        if ( Keyboard::isKeyPressed( Keyboard::T) && !isFlying && cooldownTime <= 0.0f) {
+        if (input.fly && !isFlying && cooldownTime <= 0.0f) {
             isFlying = true;
             flyTime = maxFlyTime;
             velY = -baseMaxSpeed;
-            leftAnimations[Flying]->reset();
-            rightAnimations[Flying]->reset();
+            leftAnimations[Flying].reset();
+            rightAnimations[Flying].reset();
         }
 
         if (isFlying) {
@@ -1638,22 +1566,22 @@ public:
 
         if (isFlying || !onGround) {
             if (currentState != Jumping && !isFlying) {
-                leftAnimations[Jumping]->reset();
-                rightAnimations[Jumping]->reset();
+                leftAnimations[Jumping].reset();
+                rightAnimations[Jumping].reset();
             }
             currentState = isFlying ? Flying : Jumping;
         }
         else if (abs(velX) > 0.1f) {
             if (currentState != Running) {
-                leftAnimations[Running]->reset();
-                rightAnimations[Running]->reset();
+                leftAnimations[Running].reset();
+                rightAnimations[Running].reset();
             }
             currentState = Running;
         }
         else {
             if (currentState != Idle) {
-                leftAnimations[Idle]->reset();
-                rightAnimations[Idle]->reset();
+                leftAnimations[Idle].reset();
+                rightAnimations[Idle].reset();
             }
             currentState = Idle;
         }
@@ -1670,53 +1598,23 @@ public:
             int direction = (velX > 0 && dx > 0) ? 1 : (velX < 0 && dx < 0) ? -1 : 0;
 
             if (direction != 0 && onGround) {
-                bool shouldJump = false;
                 int startCol = (direction == 1) ? rightCol : leftCol;
-
-                for (int offset = 1; offset <= 2 && !shouldJump; ++offset) {
-                    int aheadCol = startCol + offset * direction;
-                    if (aheadCol < 0 || aheadCol >= cols) break;
-                    for (int y = topRow; y <= botRow; ++y) {
-                        char tile = level[y][aheadCol];
-                        if (tile == 'w' || tile == 'b'||tile=='N') {
-                            int obstacleX = aheadCol * CELL_SIZE;
-                            bool beyond = (direction == 1) ? (targetX > obstacleX) : (targetX < obstacleX);
-                            if (beyond) {
-                                shouldJump = true;
-                            }
-                            break;
-                        }
-                    }
-                }
+                bool shouldJump = obstacleAhead(nav, startCol, direction, topRow, botRow, targetX, false);
 
                 int detectedGap = 0;
-                if (!shouldJump && botRow < rows) {
-                    for (int gapWidth = 1; gapWidth <= 4 && !shouldJump; ++gapWidth) {
-                        bool isGap = true;
-                        for (int offset = 1; offset <= gapWidth; ++offset) {
-                            int gapCol = startCol + offset * direction;
-                            if (gapCol < 0 || gapCol >= cols || level[botRow][gapCol] != ' ') {
-                                isGap = false;
-                                break;
-                            }
-                        }
-                        if (isGap) {
-                            int landingCol = startCol + (gapWidth + 1) * direction;
-                            if (landingCol >= 0 && landingCol < cols) {
-                                char landTile = level[botRow][landingCol];
-                                if (landTile == 'f' || landTile == 'p' || landTile == 'b') {
-                                    int landingX = landingCol * CELL_SIZE;
-                                    bool beyond = (direction == 1) ? (targetX > landingX) : (targetX < landingX);
-                                    if (beyond) {
-                                         cout << "Gap detected: " << gapWidth <<  endl;
-                                        shouldJump = true;
-                                        detectedGap = gapWidth;
-                                    }
-                                }
-                            }
-                        }
+                if (!shouldJump) {
+                    // Only short gaps with floor on the far side the target is past.
+                    int gapWidth = nav.gapWidth(startCol + direction, botRow, direction);
+                    int landingCol = startCol + (gapWidth + 1) * direction;
+                    int landingX = landingCol * CELL_SIZE;
+                    bool beyond = (direction == 1) ? (targetX > landingX) : (targetX < landingX);
+                    if (gapWidth > 0 && gapWidth <= 4 && nav.isFloor(landingCol, botRow) && beyond) {
+                        LOG_DEBUG("Gap detected: %d", gapWidth);
+                        shouldJump = true;
+                        detectedGap = gapWidth;
                     }
                 }
+                if (!shouldJump) shouldJump = pathJumpAhead(level, paths, gravity, jumpStrength * 1.1f, direction, targetX, targetY);
 
                 if (shouldJump) {
                     float jumpMultiplier = 1.0f + detectedGap * 1.5f;
@@ -1725,8 +1623,8 @@ public:
                     onGround = false;
                     justJumped = true;
                     jumpDelayTimer = (direction == -1) ? 1.9f : 0.2f;
-                    leftAnimations[Jumping]->reset();
-                    rightAnimations[Jumping]->reset();
+                    leftAnimations[Jumping].reset();
+                    rightAnimations[Jumping].reset();
                 }
             }
 
@@ -1746,8 +1644,8 @@ public:
                     onGround = false;
                     justJumped = true;
                     jumpQueue.dequeue();
-                    leftAnimations[Jumping]->reset();
-                    rightAnimations[Jumping]->reset();
+                    leftAnimations[Jumping].reset();
+                    rightAnimations[Jumping].reset();
                 }
             }
         }
@@ -1764,20 +1662,20 @@ public:
         }
 
         posX += velX;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level);
 
         if (isCollidingLeft && targetVelocityX < 0 && onGround) {
             currentState = Pushing;
             facingRight = false;
-            leftAnimations[Pushing]->reset();
+            leftAnimations[Pushing].reset();
         }
         else if (isCollidingRight && targetVelocityX > 0 && onGround) {
             currentState = Pushing;
             facingRight = true;
-            rightAnimations[Pushing]->reset();
+            rightAnimations[Pushing].reset();
         }
 
-        if (currentState == Idle && onGround && isOnEdge(level, rows, cols)) {
+        if (currentState == Idle && onGround && isOnEdge(level)) {
             setEdgingAnimation();
         }
 
@@ -1788,13 +1686,13 @@ public:
         onGround = false;
         float bottomY = posY + height;
         int row = static_cast<int>(bottomY / CELL_SIZE);
-        if (row < rows) {
+        if (row < level.getRows()) {
             int colLeft = static_cast<int>(checkLeftX / CELL_SIZE);
-            if (colLeft >= 0 && colLeft < cols && (level[row][colLeft] == 'f' || level[row][colLeft] == 'p' || level[row][colLeft] == 'b')) {
+            if (tileHas(level.get(colLeft, row), TILE_FLOOR)) {
                 onGround = true;
             }
             int colRight = static_cast<int>(checkRightX / CELL_SIZE);
-            if (!onGround && colRight >= 0 && colRight < cols && (level[row][colRight] == 'f' || level[row][colRight] == 'p' || level[row][colRight] == 'b')) {
+            if (!onGround && tileHas(level.get(colRight, row), TILE_FLOOR)) {
                 onGround = true;
             }
         }
@@ -1805,22 +1703,22 @@ public:
         }
 
         posY += velY;
-        applyVerticalCollision(level, rows, cols);
+        applyVerticalCollision(level);
 
-        Animation* currentAnim = nullptr;
+        AnimationState* currentAnim = nullptr;
         if (currentState == Jumping) {
-            currentAnim = facingRight ? rightAnimations[Jumping] : leftAnimations[Jumping];
+            currentAnim = facingRight ? &rightAnimations[Jumping] : &leftAnimations[Jumping];
         }
         else if (currentState == Edging) {
-            currentAnim = facingRight ? rightAnimations[Edging] : leftAnimations[Edging];
+            currentAnim = facingRight ? &rightAnimations[Edging] : &leftAnimations[Edging];
         }
         else if (currentState == Flying) {
-            currentAnim = facingRight ? rightAnimations[Flying] : leftAnimations[Flying];
+            currentAnim = facingRight ? &rightAnimations[Flying] : &leftAnimations[Flying];
         }
         else {
-            currentAnim = facingRight ? rightAnimations[currentState] : leftAnimations[currentState];
+            currentAnim = facingRight ? &rightAnimations[currentState] : &leftAnimations[currentState];
         }
-        if (currentAnim) {
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -1835,6 +1733,19 @@ public:
         else return "Press T to Fly";
     }
 
+    void resetState() override {
+        Character::resetState();
+        flyTimer = 0.0f;
+        isFlying = false;
+        flyTime = 0.0f;
+        cooldownTime = 0.0f;
+        moveTime = 0.0f;
+        previousDirection = 0;
+        isBoosted = false;
+        stuckTimer = 0.0f;
+        lastPosX = posX;
+    }
+
 private:
     float flyTimer;
     bool isFlying;
@@ -6,11 +6,12 @@
 
 class Collectable {
 public:
-    Collectable(float x, float y, float width, float height, const  Texture& texture, int scoreValue)
+    Collectable(float x, float y, float width, float height, const SpriteSheet& sheet, int scoreValue)
         : posX(x), posY(y), width(width), height(height), isCollected(false), scoreValue(scoreValue) {
-        sprite.setTexture(texture);
+        sprite.setTexture(*sheet.texture);
+        sprite.setTextureRect(sheet.rect);
         sprite.setPosition(x, y);
-        sprite.setScale(width / texture.getSize().x, height / texture.getSize().y);
+        sprite.setScale(width / sheet.rect.width, height / sheet.rect.height);
     }
 
     virtual ~Collectable() = default;
@@ -43,8 +44,10 @@ public:
     }
 
     bool getIsCollected() const { return isCollected; }
+    void setCollected(bool collected) { isCollected = collected; }
     float getPosX() const { return posX; }
     float getPosY() const { return posY; }
+    FloatRect getBounds() const { return FloatRect(posX, posY, width, height); }
     int getScoreValue() const { return scoreValue; }
 
 protected:
@@ -57,21 +60,21 @@ protected:
 
 class Ring : public Collectable {
 public:
-    Ring(float x, float y, float width, float height, const  Texture& texture)
-        : Collectable(x, y, width, height, texture, 5) {}
+    Ring(float x, float y, float width, float height, const SpriteSheet& sheet)
+        : Collectable(x, y, width, height, sheet, 5) {}
 
     void onCollect(const Character& character) override {
-        std::cout << "Ring collected! Score +5\n";
+        LOG_DEBUG("Ring collected! Score +5");
     }
 };
 
 class ExtraLife : public Collectable {
 public:
-    ExtraLife(float x, float y, float width, float height, const  Texture& texture)
-        : Collectable(x, y, width, height, texture, 10) {}
+    ExtraLife(float x, float y, float width, float height, const SpriteSheet& sheet)
+        : Collectable(x, y, width, height, sheet, 10) {}
 
     void onCollect(const Character& character) override {
-        std::cout << "Extra Life collected! Score +10, HP +1\n";
+        LOG_DEBUG("Extra Life collected! Score +10, HP +1");
     }
 };
 
@@ -81,11 +84,11 @@ public:
     static const int JUMP = 1;
     static const int INVINCIBILITY = 2;
 
-    SpecialBoost(float x, float y, float width, float height, const  Texture& texture, int type)
-        : Collectable(x, y, width, height, texture, 20), boostType(type), duration(10.0f) {}
+    SpecialBoost(float x, float y, float width, float height, const SpriteSheet& sheet, int type)
+        : Collectable(x, y, width, height, sheet, 20), boostType(type), duration(10.0f) {}
 
     void onCollect(const Character& character) override {
-        std::cout << "Boost collected! Score +20\n";
+        LOG_DEBUG("Boost collected! Score +20");
     }
 
     int getBoostType() const { return boostType; }
@@ -2,6 +2,9 @@
 #include <SFML/Graphics.hpp>
 #include "Animation.h"
 #include "Projectile.h"
+#include "TileSweep.h"
+#include "PathFinder.h"
+#include "Logger.h"
 #include <string>
 #include <iostream>
 #include <cmath>
@@ -16,7 +19,7 @@ public:
     static const int StateCount = 2;
 
     Enemy(float x, float y, int width, int height, float speed, int maxHP, float scale = 1.0f)
-        : sprite(), posX(x), posY(y), velX(0.0f), velY(0.0f), onGround(false), scale(scale),
+        : sprite(), posX(x), posY(y), prevPosX(x), prevPosY(y), velX(0.0f), velY(0.0f), onGround(false), scale(scale),
         speed(speed), maxHP(maxHP), currentHP(maxHP), currentState(Idle), isActive(true),
         facingRight(true), initialX(x), sectionLeft(x - 150.0f), sectionRight(x + 150.0f)
     {
@@ -24,19 +27,9 @@ public:
         sprite.setPosition(x, y);
         this->width = width * scale;
         this->height = height * scale;
-        for (int i = 0; i < StateCount; ++i) {
-            leftAnimations[i] = nullptr;
-            rightAnimations[i] = nullptr;
-        }
-
     }
 
-    virtual ~Enemy() {
-        for (int i = 0; i < StateCount; ++i) {
-            delete leftAnimations[i];
-            delete rightAnimations[i];
-        }
-    }
+    virtual ~Enemy() {}
 
     float getPosX() const { return posX; }
     float getPosY() const { return posY; }
@@ -45,25 +38,31 @@ public:
 
     int getEnemyWidth() const { return width; }
     int getEnemyHeight() const { return height; }
+    FloatRect getBounds() const { return FloatRect(posX, posY, width, height); }
     bool getFacingRight() const { return facingRight; }
 
-    virtual void update(float gravity, float terminalVelocity, const char** level, int rows, int cols,
+    void storePreviousPosition() { prevPosX = posX; prevPosY = posY; }
+
+    virtual void update(float gravity, float terminalVelocity, const TileGrid& level, PathFinder& paths,
         float deltaTime, float playerX, float playerY, bool playerInBallForm)
     {
         if (!isActive) return;
 
+        float fromX = posX;
         posX += velX * deltaTime;
-        applyHorizontalCollision(level, rows, cols);
+        applyHorizontalCollision(level, fromX);
+        float fromY = posY;
         posY += velY * deltaTime;
-        applyVerticalCollision(level, rows, cols, gravity, terminalVelocity, deltaTime);
+        applyVerticalCollision(level, fromY, gravity, terminalVelocity, deltaTime);
 
         updateAnimation(deltaTime);
         sprite.setPosition(posX, posY);
 
     }
 
-    virtual void draw(RenderWindow& window, const RenderStates& states = RenderStates::Default) {
+    virtual void draw(RenderWindow& window, const RenderStates& states = RenderStates::Default, float alpha = 1.0f) {
         if (isActive) {
+            sprite.setPosition(prevPosX + (posX - prevPosX) * alpha, prevPosY + (posY - prevPosY) * alpha);
             window.draw(sprite, states);
            
         }
@@ -88,6 +87,7 @@ public:
 protected:
     Sprite sprite;
     float posX, posY;
+    float prevPosX, prevPosY;
     float velX, velY;
     bool onGround;
     float scale;
@@ -95,111 +95,85 @@ protected:
     float speed;
     int maxHP, currentHP;
     bool facingRight;
-    Animation* leftAnimations[StateCount];
-    Animation* rightAnimations[StateCount];
+    AnimationState leftAnimations[StateCount];
+    AnimationState rightAnimations[StateCount];
     int currentState;
     bool isActive;
     float initialX;
     float sectionLeft, sectionRight;
-
-    // HP display
-    Font font;
    
 
    
 
-    void applyVerticalCollision(const char** level, int rows, int cols, float gravity,
+    // fromY and fromX are where the box was before this step's move; the
+    // leading edge is swept over every cell line it crossed since.
+    void applyVerticalCollision(const TileGrid& level, float fromY, float gravity,
         float terminalVelocity, float deltaTime)
     {
         int leftCol = static_cast<int>((posX + 8 * scale) / CELL_SIZE);
         int rightCol = static_cast<int>((posX + width - 8 * scale) / CELL_SIZE);
         int botRow = static_cast<int>((posY + height) / CELL_SIZE);
         int topRow = static_cast<int>(posY / CELL_SIZE);
+        int hitRow;
 
         if (!onGround) {
             velY = (velY + gravity * deltaTime < terminalVelocity) ? velY + gravity * deltaTime : terminalVelocity;
         }
 
-        if (velY > 0 && botRow < rows) {
-            bool anyFloor = false;
-            for (int x = leftCol; x <= rightCol; ++x) {
-                if (x >= 0 && x < cols && botRow < rows) {
-                    char c = level[botRow][x];
-                    if (c == 'f' || c == 'p' || c == 'b') {
-                        anyFloor = true;
-                        break;
-                    }
-                }
-            }
-            if (anyFloor) {
-                posY = (botRow * CELL_SIZE) - height;
+        if (velY > 0) {
+            int fromRow = static_cast<int>((fromY + height) / CELL_SIZE);
+            if (sweepRows(level, fromRow, botRow, leftCol, rightCol, [](char c) { return tileHas(c, TILE_FLOOR); }, hitRow)) {
+                posY = (hitRow * CELL_SIZE) - height;
                 velY = 0;
                 onGround = true;
             }
-            else {
+            else if (botRow < level.getRows()) {
                 onGround = false;
             }
         }
 
-        if (velY < 0 && topRow >= 0) {
-            bool hitCeiling = false;
-            for (int x = leftCol; x <= rightCol; ++x) {
-                if (x >= 0 && x < cols && topRow < rows) {
-                    char c = level[topRow][x];
-                    if (c == 'r' || c == 'b' || c == 'p') {
-                        hitCeiling = true;
-                        break;
-                    }
-                }
-            }
-            if (hitCeiling) {
-                posY = (topRow + 1) * CELL_SIZE;
+        if (velY < 0) {
+            int fromRow = static_cast<int>(fromY / CELL_SIZE);
+            if (sweepRows(level, fromRow, topRow, leftCol, rightCol, [](char c) { return tileHas(c, TILE_CEILING); }, hitRow)) {
+                posY = (hitRow + 1) * CELL_SIZE;
                 velY = 0;
             }
         }
 
-        if (posY > rows * CELL_SIZE) {
+        if (posY > level.getRows() * CELL_SIZE) {
             isActive = false;
         }
     }
 
-    void applyHorizontalCollision(const char** level, int rows, int cols)
+    void applyHorizontalCollision(const TileGrid& level, float fromX)
     {
-        int leftCol = static_cast<int>((posX + 8 * scale) / CELL_SIZE);
-        int rightCol = static_cast<int>((posX + width - 8 * scale) / CELL_SIZE);
         int topRow = static_cast<int>((posY + 5 * scale) / CELL_SIZE);
         int botRow = static_cast<int>((posY + height - 5 * scale) / CELL_SIZE);
-
-        if (velX < 0 && leftCol >= 0) {
-            for (int y = topRow; y <= botRow; ++y) {
-                if (y >= 0 && y < rows && leftCol < cols) {
-                    char c = level[y][leftCol];
-                    if (c == 'w' || c == 'b' || c == 'p') {
-                        posX = (leftCol + 1) * CELL_SIZE - 8 * scale;
-                        velX = 0;
-                        break;
-                    }
-                }
+        auto solid = [](char c) { return tileHas(c, TILE_SOLID_SIDE); };
+        int hitCol;
+
+        if (velX < 0) {
+            int fromCol = static_cast<int>((fromX + 8 * scale) / CELL_SIZE);
+            int leftCol = static_cast<int>((posX + 8 * scale) / CELL_SIZE);
+            if (sweepColumns(level, fromCol, leftCol, topRow, botRow, solid, hitCol)) {
+                posX = (hitCol + 1) * CELL_SIZE - 8 * scale;
+                velX = 0;
             }
         }
 
-        if (velX > 0 && rightCol < cols) {
-            for (int y = topRow; y <= botRow; ++y) {
-                if (y >= 0 && y < rows && rightCol >= 0) {
-                    char c = level[y][rightCol];
-                    if (c == 'w' || c == 'b' || c == 'p') {
-                        posX = rightCol * CELL_SIZE - width + 8 * scale;
-                        velX = 0;
-                        break;
-                    }
-                }
+        if (velX > 0) {
+            int fromCol = static_cast<int>((fromX + width - 8 * scale) / CELL_SIZE);
+            int rightCol = static_cast<int>((posX + width - 8 * scale) / CELL_SIZE);
+            if (sweepColumns(level, fromCol, rightCol, topRow, botRow, solid, hitCol)) {
+                posX = hitCol * CELL_SIZE - width + 8 * scale;
+                velX = 0;
             }
         }
     }
 
     void updateAnimation(float deltaTime) {
-        Animation* currentAnim = facingRight ? rightAnimations[currentState] : leftAnimations[currentState];
-        if (currentAnim) {
+        AnimationState* currentAnim = facingRight ? &rightAnimations[currentState] : &leftAnimations[currentState];
+        if (currentAnim && currentAnim->isValid()) {
             currentAnim->update(deltaTime);
             sprite.setTexture(*currentAnim->getTexture());
             sprite.setTextureRect(currentAnim->getCurrentFrame());
@@ -210,8 +184,8 @@ protected:
 class BatBrain : public Enemy {
 public:
     char getType() const override { return 'B'; }
-    BatBrain(float x, float y, float scale, Texture& idleLeft, Texture& idleRight,
-        Texture& moveLeft, Texture& moveRight)
+    BatBrain(float x, float y, float scale, const SpriteSheet& idleLeft, const SpriteSheet& idleRight,
+        const SpriteSheet& moveLeft, const SpriteSheet& moveRight)
         : Enemy(x, y, 32, 32, 90.0f, 3, 2.0f)  // HP is 3
     {
         const int FRAME_WIDTH = 32;
@@ -221,25 +195,25 @@ public:
         sectionLeft = x - 120.0f;
         sectionRight = x + 120.0f;
 
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
 
-        int moveLeftFrames = moveLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Moving] = new Animation(&moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
-        int moveRightFrames = moveRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Moving] = new Animation(&moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
+        int moveLeftFrames = moveLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Moving] = AnimationState(moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
+        int moveRightFrames = moveRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Moving] = AnimationState(moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
 
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
 
      
     }
 
-    void update(float gravity, float terminalVelocity, const char** level, int rows, int cols,
+    void update(float gravity, float terminalVelocity, const TileGrid& level, PathFinder& paths,
         float deltaTime, float playerX, float playerY, bool playerInBallForm) override
     {
         if (!isActive) {
-            Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+            Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
             return;
         }
 
@@ -249,8 +223,23 @@ public:
 
         if (distance < 300.0f) {
             currentState = Moving;
-            velX = (dx > 0 ? speed * 0.6f : -speed * 0.6f);
-            velY = (dy > 0 ? speed * 0.6f : -speed * 0.6f);
+            // Fly round walls along the path; straight at the player until one is known.
+            PathFinder::Step step;
+            int fromCol = static_cast<int>((posX + width / 2.0f) / CELL_SIZE);
+            int fromRow = static_cast<int>((posY + height / 2.0f) / CELL_SIZE);
+            int toCol = static_cast<int>(playerX / CELL_SIZE);
+            int toRow = static_cast<int>(playerY / CELL_SIZE);
+            if (paths.nextStep(level, PathFinder::FLYER, 1, 0, fromCol, fromRow, toCol, toRow, step) == PathFinder::FOUND &&
+                (step.x != fromCol || step.y != fromRow)) {
+                float aimX = step.x * CELL_SIZE + (CELL_SIZE - width) / 2.0f - posX;
+                float aimY = step.y * CELL_SIZE + (CELL_SIZE - height) / 2.0f - posY;
+                velX = abs(aimX) > 1.0f ? (aimX > 0 ? speed * 0.6f : -speed * 0.6f) : 0.0f;
+                velY = abs(aimY) > 1.0f ? (aimY > 0 ? speed * 0.6f : -speed * 0.6f) : 0.0f;
+            }
+            else {
+                velX = (dx > 0 ? speed * 0.6f : -speed * 0.6f);
+                velY = (dy > 0 ? speed * 0.6f : -speed * 0.6f);
+            }
             facingRight = dx > 0;
         }
         else {
@@ -275,15 +264,15 @@ public:
             facingRight = false;
         }
 
-        Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+        Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
     }
 };
 
 class BeeBot : public Enemy {
 public:
     char getType() const override { return 'E'; }
-    BeeBot(float x, float y, float scale, Texture& idleLeft, Texture& idleRight,
-        Texture& moveLeft, Texture& moveRight)
+    BeeBot(float x, float y, float scale, const SpriteSheet& idleLeft, const SpriteSheet& idleRight,
+        const SpriteSheet& moveLeft, const SpriteSheet& moveRight)
         : Enemy(x, y, 32, 32, 120.0f, 5, 1.5f),
         shootTimer(0.0f), shootCooldown(5.0f)
     {
@@ -294,25 +283,25 @@ public:
         sectionLeft = x - 180.0f;
         sectionRight = x + 180.0f;
 
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
 
-        int moveLeftFrames = moveLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Moving] = new Animation(&moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
-        int moveRightFrames = moveRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Moving] = new Animation(&moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
+        int moveLeftFrames = moveLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Moving] = AnimationState(moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
+        int moveRightFrames = moveRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Moving] = AnimationState(moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
 
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
 
         
     }
 
-    void update(float gravity, float terminalVelocity, const char** level, int rows, int cols,
+    void update(float gravity, float terminalVelocity, const TileGrid& level, PathFinder& paths,
         float deltaTime, float playerX, float playerY, bool playerInBallForm) override
     {
         if (!isActive) {
-            Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+            Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
             return;
         }
 
@@ -348,12 +337,12 @@ public:
             facingRight = false;
         }
 
-        Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+        Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
     }
 
     Projectile* shootProjectile(float playerX, float playerY, Texture& projectileTexture)
     {
-        cout << "BeeBot shooting projectile!" << endl;
+        LOG_DEBUG("BeeBot shooting projectile!");
         float startX = posX + (facingRight ? width : -16);
         float startY = posY + height / 2;
         return new Projectile(startX, startY, playerX, playerY, 100.0f, projectileTexture);
@@ -366,8 +355,8 @@ private:
 class Motobug : public Enemy {
 public:
     char getType() const override { return 'M'; }
-    Motobug(float x, float y, float scale, Texture& idleLeft, Texture& idleRight,
-        Texture& moveLeft, Texture& moveRight)
+    Motobug(float x, float y, float scale, const SpriteSheet& idleLeft, const SpriteSheet& idleRight,
+        const SpriteSheet& moveLeft, const SpriteSheet& moveRight)
         : Enemy(x, y, 32, 32, 30.0f, 4, scale),
         startX(x), patrolState(0), shootTimer(0.0f), shootCooldown(5.0f), justSawPlayer(false)
     {
@@ -375,23 +364,23 @@ public:
         const int FRAME_HEIGHT = 32;
         const float FRAME_DURATION = 0.1f;
 
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
 
-        int moveLeftFrames = moveLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Moving] = new Animation(&moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
-        int moveRightFrames = moveRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Moving] = new Animation(&moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
+        int moveLeftFrames = moveLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Moving] = AnimationState(moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
+        int moveRightFrames = moveRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Moving] = AnimationState(moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
 
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
     }
 
-    void update(float gravity, float terminalVelocity, const char** level, int rows, int cols,
+    void update(float gravity, float terminalVelocity, const TileGrid& level, PathFinder& paths,
         float deltaTime, float playerX, float playerY, bool playerInBallForm) override
     {
         if (!isActive) {
-            Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+            Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
             return;
         }
 
@@ -407,10 +396,25 @@ public:
             shootTimer = shootCooldown; // Trigger immediate shot when player enters range
         }
 
+        // Chase along the floor while the player can be reached that way, and
+        // keep patrolling when they cannot instead of pushing into a wall.
+        int chase = PathFinder::NO_PATH;
+        PathFinder::Step step;
         if (distance < 300.0f) {
+            int fromCol = static_cast<int>((posX + width / 2.0f) / CELL_SIZE);
+            int fromRow = static_cast<int>((posY + height - 1) / CELL_SIZE);
+            chase = paths.nextStep(level, PathFinder::WALKER, (height + CELL_SIZE - 1) / CELL_SIZE, 0, fromCol, fromRow,
+                static_cast<int>(playerX / CELL_SIZE), static_cast<int>(playerY / CELL_SIZE), step);
+        }
+
+        if (chase != PathFinder::NO_PATH) {
             currentState = Moving;
-            velX = (dx > 0 ? speed * 0.6f : -speed * 0.6f);
-            facingRight = dx > 0;
+            float aim = dx;
+            if (chase == PathFinder::FOUND && step.x != static_cast<int>((posX + width / 2.0f) / CELL_SIZE)) {
+                aim = step.x * CELL_SIZE + CELL_SIZE / 2.0f - (posX + width / 2.0f);
+            }
+            velX = (aim > 0 ? speed * 0.6f : -speed * 0.6f);
+            facingRight = aim > 0;
         }
         else {
             currentState = Moving;
@@ -471,12 +475,12 @@ public:
             patrolState = 1;
         }
 
-        Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+        Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
     }
 
     Projectile* shootProjectile(float playerX, float playerY, Texture& projectileTexture)
     {
-        cout << "Motobug shooting projectile!" << endl;
+        LOG_DEBUG("Motobug shooting projectile!");
         float startX = posX + (facingRight ? width : -16);
         float startY = posY + height / 2;
         return new Projectile(startX, startY, playerX, playerY, 100.0f, projectileTexture);
@@ -501,8 +505,8 @@ private:
 class CrabMeat : public Enemy {
 public:
     char getType() const override { return 'C'; }
-    CrabMeat(float x, float y, float scale, Texture& idleLeft, Texture& idleRight,
-        Texture& moveLeft, Texture& moveRight)
+    CrabMeat(float x, float y, float scale, const SpriteSheet& idleLeft, const SpriteSheet& idleRight,
+        const SpriteSheet& moveLeft, const SpriteSheet& moveRight)
         : Enemy(x, y, 32, 32, 30.0f, 4, 3.0f),
         startX(x), patrolState(0), shootTimer(0.0f), shootCooldown(5.0f), justSawPlayer(false)
     {
@@ -510,23 +514,23 @@ public:
         const int FRAME_HEIGHT = 32;
         const float FRAME_DURATION = 0.1f;
 
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
 
-        int moveLeftFrames = moveLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Moving] = new Animation(&moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
-        int moveRightFrames = moveRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Moving] = new Animation(&moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
+        int moveLeftFrames = moveLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Moving] = AnimationState(moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
+        int moveRightFrames = moveRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Moving] = AnimationState(moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
 
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
     }
 
-    void update(float gravity, float terminalVelocity, const char** level, int rows, int cols,
+    void update(float gravity, float terminalVelocity, const TileGrid& level, PathFinder& paths,
         float deltaTime, float playerX, float playerY, bool playerInBallForm) override
     {
         if (!isActive) {
-            Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+            Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
             return;
         }
 
@@ -599,12 +603,12 @@ public:
             patrolState = 1;
         }
 
-        Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+        Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
     }
 
     Projectile* shootProjectile(float playerX, float playerY, Texture& projectileTexture)
     {
-        cout << "CrabMeat shooting projectile!" << endl;
+        LOG_DEBUG("CrabMeat shooting projectile!");
         float startX = posX + (facingRight ? width : -16);
         float startY = posY + height / 2;
         return new Projectile(startX, startY, playerX, playerY, 100.0f, projectileTexture);
@@ -629,8 +633,8 @@ private:
 class EggStinger : public Enemy {
 public:
     char getType() const override { return 'S'; }
-    EggStinger(float x, float y, float scale, Texture& idleLeft, Texture& idleRight,
-        Texture& moveLeft, Texture& moveRight)
+    EggStinger(float x, float y, float scale, const SpriteSheet& idleLeft, const SpriteSheet& idleRight,
+        const SpriteSheet& moveLeft, const SpriteSheet& moveRight)
         : Enemy(x, y, 32, 32, 18.0f, 15, scale)
     {
         const int FRAME_WIDTH = 32;
@@ -640,25 +644,25 @@ public:
         sectionLeft = x - 300.0f;
         sectionRight = x + 300.0f;
 
-        leftAnimations[Idle] = new Animation(&idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
-        rightAnimations[Idle] = new Animation(&idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        leftAnimations[Idle] = AnimationState(idleLeft, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
+        rightAnimations[Idle] = AnimationState(idleRight, FRAME_WIDTH, FRAME_HEIGHT, 1, FRAME_DURATION);
 
-        int moveLeftFrames = moveLeft.getSize().x / FRAME_WIDTH;
-        leftAnimations[Moving] = new Animation(&moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
-        int moveRightFrames = moveRight.getSize().x / FRAME_WIDTH;
-        rightAnimations[Moving] = new Animation(&moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
+        int moveLeftFrames = moveLeft.rect.width / FRAME_WIDTH;
+        leftAnimations[Moving] = AnimationState(moveLeft, FRAME_WIDTH, FRAME_HEIGHT, moveLeftFrames, FRAME_DURATION);
+        int moveRightFrames = moveRight.rect.width / FRAME_WIDTH;
+        rightAnimations[Moving] = AnimationState(moveRight, FRAME_WIDTH, FRAME_HEIGHT, moveRightFrames, FRAME_DURATION);
 
-        sprite.setTexture(*rightAnimations[Idle]->getTexture());
-        sprite.setTextureRect(rightAnimations[Idle]->getCurrentFrame());
+        sprite.setTexture(*rightAnimations[Idle].getTexture());
+        sprite.setTextureRect(rightAnimations[Idle].getCurrentFrame());
 
        
     }
 
-    void update(float gravity, float terminalVelocity, const char** level, int rows, int cols,
+    void update(float gravity, float terminalVelocity, const TileGrid& level, PathFinder& paths,
         float deltaTime, float playerX, float playerY, bool playerInBallForm) override
     {
         if (!isActive) {
-            Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+            Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
             return;
         }
 
@@ -692,6 +696,6 @@ public:
             facingRight = false;
         }
 
-        Enemy::update(gravity, terminalVelocity, level, rows, cols, deltaTime, playerX, playerY, playerInBallForm);
+        Enemy::update(gravity, terminalVelocity, level, paths, deltaTime, playerX, playerY, playerInBallForm);
     }
 };
\ No newline at end of file
@@ -4,32 +4,59 @@
 #include "PositionQueue.h"
 #include "Enemies.h"
 #include "Collectable.h"
+#include "TileGrid.h"
+#include "TileMap.h"
+#include "NavGraph.h"
+#include "PathFinder.h"
+#include "Arena.h"
+#include "LevelStream.h"
+#include "LevelFormat.h"
+#include "MappedFile.h"
+#include "SpatialHash.h"
+#include "Input.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "AssetCache.h"
+#include "TextureAtlas.h"
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstdlib>
+#include <ctime>
 #include "Menu.h"
 #include "PauseMenu.h"
 #include "Menu.cpp"  // Including implementation files directly
 #include "PauseMenu.cpp"
 
+// Read the text level files when no compiled level exists. No level_N.bin
+// ships yet, so this stays on; a build that packs every level with
+// data/level_compiler can define it to 0, and a missing blob is then an error.
+#ifndef LEVEL_TEXT_FALLBACK
+#define LEVEL_TEXT_FALLBACK 1
+#endif
+
 class Game {
 public:
-    Game();
+    Game(bool headless = false);
     ~Game();
     void run();
-    void initializeLevel(int level);
+    int runHeadless(InputSource& input, int level, int maxFrames);
+    int runReplay(const string& filename);
+    void setRecordFile(const string& filename) { recordPath = filename; }
+    void setReplayFile(const string& filename) { replayPath = filename; }
+    bool initializeLevel(int level);
     int getScore() const { return score; }
     void saveGame() {
         if (currentSaveSlot.empty()) {
-            cout << "No save slot selected.\n";
+            LOG_WARN("No save slot selected.");
             return;
         }
         string filename = "save_" + currentSaveSlot.substr(5) + ".txt"; // e.g., "save_1.txt"
         ofstream out(filename);
         if (!out.is_open()) {
-            cout << "Failed to save game to " << filename << "\n";
+            LOG_ERROR("Failed to save game to %s", filename.c_str());
             return;
         }
 
@@ -49,12 +76,31 @@ public:
                 out << enemies[i]->getType() << " " << enemies[i]->getPosX() << " " << enemies[i]->getPosY() << "\n";
             }
         }
-        out << rows << " " << cols << "\n";
-        for (int y = 0; y < rows; ++y) {
-            for (int x = 0; x < cols; ++x) {
-                out << mapData[y][x];
+        out << tiles.getRows() << " " << tiles.getCols() << "\n";
+        if (levelStream.isOpen()) {
+            // Only a window of a streamed level is resident; gather the rest chunk by chunk.
+            int width = levelStream.getChunkWidth();
+            char* chunk = new char[tiles.getRows() * width];
+            char* map = new char[tiles.getRows() * tiles.getCols()];
+            for (int c = 0; c < levelStream.getChunkCount(); ++c) {
+                levelStream.readChunk(tiles, c, chunk);
+                int chunkCols = min(width, tiles.getCols() - c * width);
+                for (int y = 0; y < tiles.getRows(); ++y) {
+                    memcpy(map + y * tiles.getCols() + c * width, chunk + y * width, chunkCols);
+                }
+            }
+            for (int y = 0; y < tiles.getRows(); ++y) {
+                out.write(map + y * tiles.getCols(), tiles.getCols());
+                out << "\n";
+            }
+            delete[] map;
+            delete[] chunk;
+        }
+        else {
+            for (int y = 0; y < tiles.getRows(); ++y) {
+                out.write(tiles.rowData(y), tiles.getCols());
+                out << "\n";
             }
-            out << "\n";
         }
         out << score << "\n";
         out << collectableCount << "\n";
@@ -64,13 +110,13 @@ public:
         out << speedBoostTimer << " " << jumpBoostTimer << " " << invincibilityTimer << "\n";
         out << playerName << "\n"; // Save player name
         out.close();
-        cout << "Game saved to " << filename << "\n";
+        LOG_INFO("Game saved to %s", filename.c_str());
     }
 
     void loadGame(const string& filename) {
         ifstream in(filename);
         if (!in.is_open()) {
-            cout << "Failed to open save file.\n";
+            LOG_ERROR("Failed to open save file.");
             return;
         }
 
@@ -97,11 +143,23 @@ public:
         int aliveEnemies;
         in >> aliveEnemies;
 
-        for (int i = 0; i < enemyCount; ++i) {
-            delete enemies[i];
-            enemies[i] = nullptr;
+        releaseEntities();
+
+        // The saved enemy types decide which textures stay, so read the list
+        // once for them before creating anything.
+        if (levelTextureCount > 0) {
+            bool needed[LEVEL_TEXTURES] = {};
+            needed[levelBackground(currentLevel)] = true;
+            markCollectableTexture('R', needed);
+            streampos enemyList = in.tellg();
+            char type;
+            float posX, posY;
+            for (int i = 0; i < aliveEnemies && in >> type >> posX >> posY; ++i) markEnemyTextures(type, needed);
+            in.clear();
+            in.seekg(enemyList);
+            retainLevelTextures(needed);
         }
-        enemyCount = 0;
+        setBackground(levelBackground(currentLevel));
 
         for (int i = 0; i < aliveEnemies; ++i) {
             char type;
@@ -110,19 +168,19 @@ public:
             float scale = 2.0f;
             switch (type) {
             case 'B':
-                enemies[enemyCount] = new BatBrain(posX, posY, scale, batBrainIdleLeftTexture, batBrainIdleRightTexture, batBrainMoveLeftTexture, batBrainMoveRightTexture);
+                enemies[enemyCount] = levelArena.create<BatBrain>(posX, posY, scale, batBrainIdleLeftTexture, batBrainIdleRightTexture, batBrainMoveLeftTexture, batBrainMoveRightTexture);
                 break;
             case 'E':
-                enemies[enemyCount] = new BeeBot(posX, posY, scale, beeBotIdleLeftTexture, beeBotIdleRightTexture, beeBotMoveLeftTexture, beeBotMoveRightTexture);
+                enemies[enemyCount] = levelArena.create<BeeBot>(posX, posY, scale, beeBotIdleLeftTexture, beeBotIdleRightTexture, beeBotMoveLeftTexture, beeBotMoveRightTexture);
                 break;
             case 'M':
-                enemies[enemyCount] = new Motobug(posX, posY, scale, motobugIdleLeftTexture, motobugIdleRightTexture, motobugMoveLeftTexture, motobugMoveRightTexture);
+                enemies[enemyCount] = levelArena.create<Motobug>(posX, posY, scale, motobugIdleLeftTexture, motobugIdleRightTexture, motobugMoveLeftTexture, motobugMoveRightTexture);
                 break;
             case 'C':
-                enemies[enemyCount] = new CrabMeat(posX, posY, scale, crabMeatIdleLeftTexture, crabMeatIdleRightTexture, crabMeatMoveLeftTexture, crabMeatMoveRightTexture);
+                enemies[enemyCount] = levelArena.create<CrabMeat>(posX, posY, scale, crabMeatIdleLeftTexture, crabMeatIdleRightTexture, crabMeatMoveLeftTexture, crabMeatMoveRightTexture);
                 break;
             case 'S':
-                enemies[enemyCount] = new EggStinger(posX, posY, scale, eggStingerIdleLeftTexture, eggStingerIdleRightTexture, eggStingerMoveLeftTexture, eggStingerMoveRightTexture);
+                enemies[enemyCount] = levelArena.create<EggStinger>(posX, posY, scale, eggStingerIdleLeftTexture, eggStingerIdleRightTexture, eggStingerMoveLeftTexture, eggStingerMoveRightTexture);
                 break;
             default:
                 continue;
@@ -134,52 +192,42 @@ public:
         in >> savedRows >> savedCols;
         string line;
 
-        if (savedRows != rows || savedCols != cols) {
-            cout << "Map size mismatch. Loading new map.\n";
-            if (mapData) {
-                for (int i = 0; i < rows; ++i) {
-                    delete[] mapData[i];
-                }
-                delete[] mapData;
-            }
-            rows = savedRows;
-            cols = savedCols;
-            mapData = new char* [rows];
-            for (int i = 0; i < rows; ++i) {
-                mapData[i] = new char[cols];
-            }
+        if (savedRows != tiles.getRows() || savedCols != tiles.getCols()) {
+            LOG_WARN("Map size mismatch. Loading new map.");
         }
+        // A save holds the whole map, so it comes back fully resident in the
+        // grid's own buffer, whether the level was streamed or mapped.
+        levelStream.close();
+        tiles.resize(savedRows, savedCols);
+        levelMapping.close();
         in.ignore(numeric_limits<streamsize>::max(), '\n');
-        for (int y = 0; y < rows; ++y) {
+        for (int y = 0; y < tiles.getRows(); ++y) {
             getline(in, line);
-            if (line.length() < static_cast<size_t>(cols)) {
-                cout << "Invalid map data.\n";
+            if (line.length() < static_cast<size_t>(tiles.getCols())) {
+                LOG_ERROR("Invalid map data.");
                 return;
             }
-            for (int x = 0; x < cols; ++x) {
-                mapData[y][x] = line[x];
-            }
+            line.copy(tiles.rowData(y), tiles.getCols());
         }
-        level = const_cast<const char**>(mapData);
-        levelWidth = cols * CELL_SIZE;
-        levelHeight = rows * CELL_SIZE;
+        navGraph.build(tiles);
+        pathFinder.clear();
+        if (!headless) tileMap.build(tiles, CELL_SIZE);
+        levelWidth = tiles.getCols() * CELL_SIZE;
+        levelHeight = tiles.getRows() * CELL_SIZE;
 
         in >> score;
         int loadedCollectableCount;
         in >> loadedCollectableCount;
-        for (int i = 0; i < collectableCount; ++i) {
-            delete collectables[i];
-            collectables[i] = nullptr;
-        }
-        collectableCount = 0;
         for (int i = 0; i < loadedCollectableCount && collectableCount < MAX_COLLECTABLES; ++i) {
             float posX, posY;
             bool isCollected;
             in >> posX >> posY >> isCollected;
-            collectables[collectableCount] = new Ring(posX, posY, 32.0f, 32.0f, ringTexture);
-            if (isCollected) collectables[collectableCount]->onCollect(*characters[mainIndex]);
+            collectables[collectableCount] = levelArena.create<Ring>(posX, posY, 32.0f, 32.0f, ringTexture);
+            collectables[collectableCount]->setCollected(isCollected);
             collectableCount++;
         }
+        indexEnemies();
+        indexCollectables();
         in >> speedBoostTimer >> jumpBoostTimer >> invincibilityTimer;
         in >> playerName; // Load player name
         updateBoosts(0.0f);
@@ -188,40 +236,60 @@ public:
     }
 
 private:
-    Texture wallTexture, backgroundTexture[3], blockTexture, platformTexture, crystalTexture, block3Texture, spikeTexture, pitTexture, block4Texture;
-    Texture grassTexture;
-    Texture sonicIdleLeftTexture, sonicIdleRightTexture;
-    Texture sonicRunLeftTexture, sonicRunRightTexture;
-    Texture sonicJumpTexture;
-    Texture sonicPushLeftTexture, sonicPushRightTexture;
-    Texture sonicEdgeLeftTexture, sonicEdgeRightTexture;
-    Texture knucklesIdleLeftTexture, knucklesIdleRightTexture;
-    Texture knucklesRunLeftTexture, knucklesRunRightTexture;
-    Texture knucklesJumpLeftTexture, knucklesJumpRightTexture;
-    Texture knucklesPushLeftTexture, knucklesPushRightTexture;
-    Texture knucklesEdgeLeftTexture, knucklesEdgeRightTexture;
-    Texture knucklesPunchLeftTexture, knucklesPunchRightTexture;
-    Texture tailsIdleLeftTexture, tailsIdleRightTexture;
-    Texture tailsRunLeftTexture, tailsRunRightTexture;
-    Texture tailsJumpTexture;
-    Texture tailsFlyLeftTexture, tailsFlyRightTexture;
-    Texture tailsPushLeftTexture, tailsPushRightTexture;
-    Texture tailsEdgeLeftTexture, tailsEdgeRightTexture;
-    Texture batBrainIdleLeftTexture, batBrainIdleRightTexture;
-    Texture batBrainMoveLeftTexture, batBrainMoveRightTexture;
-    Texture beeBotIdleLeftTexture, beeBotIdleRightTexture;
-    Texture beeBotMoveLeftTexture, beeBotMoveRightTexture;
-    Texture motobugIdleLeftTexture, motobugIdleRightTexture;
-    Texture motobugMoveLeftTexture, motobugMoveRightTexture;
-    Texture crabMeatIdleLeftTexture, crabMeatIdleRightTexture;
-    Texture crabMeatMoveLeftTexture, crabMeatMoveRightTexture;
-    Texture eggStingerIdleLeftTexture, eggStingerIdleRightTexture;
-    Texture eggStingerMoveLeftTexture, eggStingerMoveRightTexture;
-    Texture ringTexture, extraLifeTexture, speedBoostTexture, jumpBoostTexture, invincibilityBoostTexture;
-
-    Sprite backgroundSprite, blockSprite, platformSprite, crystalSprite, block3Sprite, block4Sprite, spikeSprite, pitSprite;
-    Sprite grassSprite;
-    Font font;
+    friend class GameBench; // bench/Benchmark.cpp drives the private update passes
+    bool headless;
+    bool assetsFailed;
+    AssetCache assets;
+    TextureAtlas atlas;
+    Clock startupClock;
+    SpriteSheet backgroundTexture[3];
+    SpriteSheet wallTexture, blockTexture, platformTexture, crystalTexture, block3Texture, spikeTexture, pitTexture, block4Texture;
+    SpriteSheet grassTexture;
+    SpriteSheet sonicIdleLeftTexture, sonicIdleRightTexture;
+    SpriteSheet sonicRunLeftTexture, sonicRunRightTexture;
+    SpriteSheet sonicJumpTexture;
+    SpriteSheet sonicPushLeftTexture, sonicPushRightTexture;
+    SpriteSheet sonicEdgeLeftTexture, sonicEdgeRightTexture;
+    SpriteSheet knucklesIdleLeftTexture, knucklesIdleRightTexture;
+    SpriteSheet knucklesRunLeftTexture, knucklesRunRightTexture;
+    SpriteSheet knucklesJumpLeftTexture, knucklesJumpRightTexture;
+    SpriteSheet knucklesPushLeftTexture, knucklesPushRightTexture;
+    SpriteSheet knucklesEdgeLeftTexture, knucklesEdgeRightTexture;
+    SpriteSheet knucklesPunchLeftTexture, knucklesPunchRightTexture;
+    SpriteSheet tailsIdleLeftTexture, tailsIdleRightTexture;
+    SpriteSheet tailsRunLeftTexture, tailsRunRightTexture;
+    SpriteSheet tailsJumpTexture;
+    SpriteSheet tailsFlyLeftTexture, tailsFlyRightTexture;
+    SpriteSheet tailsPushLeftTexture, tailsPushRightTexture;
+    SpriteSheet tailsEdgeLeftTexture, tailsEdgeRightTexture;
+    SpriteSheet batBrainIdleLeftTexture, batBrainIdleRightTexture;
+    SpriteSheet batBrainMoveLeftTexture, batBrainMoveRightTexture;
+    SpriteSheet beeBotIdleLeftTexture, beeBotIdleRightTexture;
+    SpriteSheet beeBotMoveLeftTexture, beeBotMoveRightTexture;
+    SpriteSheet motobugIdleLeftTexture, motobugIdleRightTexture;
+    SpriteSheet motobugMoveLeftTexture, motobugMoveRightTexture;
+    SpriteSheet crabMeatIdleLeftTexture, crabMeatIdleRightTexture;
+    SpriteSheet crabMeatMoveLeftTexture, crabMeatMoveRightTexture;
+    SpriteSheet eggStingerIdleLeftTexture, eggStingerIdleRightTexture;
+    SpriteSheet eggStingerMoveLeftTexture, eggStingerMoveRightTexture;
+    SpriteSheet ringTexture, extraLifeTexture, speedBoostTexture, jumpBoostTexture, invincibilityBoostTexture;
+
+    // Textures only some levels use: backgrounds, then four per enemy type in
+    // "BEMCS" order, then one per collectable type in "RESJI" order.
+    // retainLevelTextures() keeps just the ones the current level needs.
+    static const int BACKGROUND_COUNT = 3;
+    static const int ENEMY_KINDS = 5;
+    static const int COLLECTABLE_KINDS = 5;
+    static const int LEVEL_TEXTURES = BACKGROUND_COUNT + ENEMY_KINDS * 4 + COLLECTABLE_KINDS;
+    const char* levelTextureFiles[LEVEL_TEXTURES];
+    SpriteSheet* levelTextureSheets[LEVEL_TEXTURES];
+    bool levelTextureResident[LEVEL_TEXTURES];
+    int levelTextureCount; // stays 0 in headless runs, which load no textures
+    size_t levelTextureBytes; // atlas pages resident once the current level's textures are in
+
+    Sprite backgroundSprite;
+    TileMap tileMap;
+    FontHandle font;
     Text timerText;
     Text gameTimerText;
     Text scoreText;
@@ -235,16 +303,20 @@ private:
     float speedBoostTimer;
     float jumpBoostTimer;
     int currentLevel;
-    const char** level;
-    char** mapData;
-    int rows, cols;
+    TileGrid tiles;
+    NavGraph navGraph; // follower lookahead over tiles, rebuilt with it
+    PathFinder pathFinder; // paths over tiles, cleared with navGraph
+    LevelStream levelStream;
+    MappedFile levelMapping; // backs tiles while a compiled level is mapped
     float startX, startY;
     float levelWidth, levelHeight;
     Time initialTime;
 
     Character* characters[3];
     int mainIndex;
+    float cameraX, cameraY;
     float offScreenTimers[3];
+    float hitInvincibilityTimers[3];
     int drawOrder[3];
     float maxSpeed;
 
@@ -252,174 +324,142 @@ private:
     PositionQueue positionQueue;
     const int delayFrames;
 
-    static const int MAX_ENEMIES = 50;
+    // Caps catch-up work after a long stall so a slow frame can't snowball.
+    static const int MAX_STEPS_PER_FRAME = 5;
+
+    static const int MAX_ENEMIES = 4096;
     Enemy* enemies[MAX_ENEMIES];
     int enemyCount;
+    SpatialHash enemyGrid;
 
     PauseMenu pauseMenu;
     bool isPaused;
+    KeyboardInput keyboardInput;
+    InputRecorder recorder;
+    Profiler profiler;
+    string recordPath;
+    string replayPath;
+    unsigned int seed;
 
     string currentSaveSlot;
-    static const int MAX_COLLECTABLES = 100;
+    static const int MAX_COLLECTABLES = 8192;
     Collectable* collectables[MAX_COLLECTABLES];
     int collectableCount;
+    SpatialHash collectableGrid;
+
+    // Every enemy and collectable of the current level; releaseEntities()
+    // frees them all at once.
+    Arena levelArena;
+
+    // Scratch space for spatial hash queries.
+    static const int MAX_NEARBY = 256;
+    int nearby[MAX_NEARBY];
+    bool nearbyOverflowLogged;
     int score;
     string playerName; // Added to store player name
 
+    bool beginAssetLoading();
+    bool showLoadingScreen(RenderWindow& window);
+    void applyLoadedAssets();
+    void createWorld();
+    void setBackground(int index);
+    int levelBackground(int level) const { return level >= 1 && level <= BACKGROUND_COUNT ? level - 1 : 0; }
+    void addLevelTexture(const char* file, SpriteSheet& sheet);
+    void markEnemyTextures(char type, bool* needed) const;
+    void markCollectableTexture(char type, bool* needed) const;
+    void scanLevelTextures(const string& levelFile, const string& enemiesFile, const string& collectablesFile, bool* needed) const;
+    void loadLevelTextures(int background, const string& levelFile, const string& enemiesFile, const string& collectablesFile);
+    void retainLevelTextures(const bool* needed);
+    void simulateFrame(float deltaTime, const InputState& input);
+    void updateCamera(float alpha = 1.0f);
+    void streamLevel();
+    void setMainCharacter(int index);
+    void startRecording();
     void updateDrawOrder();
     void loadMap(const string& filename);
     void loadEnemies(const string& filename);
     void updateEnemies(float deltaTime, float gravity, float terminalVelocity);
-    void drawEnemies(RenderWindow& window, const RenderStates& states);
-    void checkCollisions();
-    void drawLevel(RenderWindow& window, Sprite& wallSprite, const RenderStates& states);
-    void checkCharacterRespawn(float cameraX, float cameraY);
-    void checkHazardCollisions(int& sharedHP, float& invincibilityTimer);
+    void drawEnemies(RenderWindow& window, const RenderStates& states, const FloatRect& visibleArea, float alpha);
+    void checkCollisions(float deltaTime);
+    void drawLevel(RenderWindow& window, const RenderStates& states, const FloatRect& visibleArea);
+    void checkCharacterRespawn(float cameraX, float cameraY, float deltaTime);
+    void checkHazardCollisions(int& sharedHP, float& invincibilityTimer, float deltaTime);
     void respawnCharacter(int charIndex, bool isMain);
     void handlePause(RenderWindow& window);
     void loadCollectables(const string& filename);
+    bool loadCompiledLevel(const string& filename, bool withTiles);
+    Enemy* createEnemy(char type, float x, float y);
+    Collectable* createCollectable(char type, float x, float y);
+    void releaseEntities();
+    int queryNearby(const SpatialHash& grid, const FloatRect& area);
+    void indexEnemies();
+    void indexCollectables();
     void updateCollectables();
-    void drawCollectables(RenderWindow& window, const RenderStates& states);
+    void drawCollectables(RenderWindow& window, const RenderStates& states, const FloatRect& visibleArea);
     void applyBoost(Character* character, int type, float duration);
     void updateBoosts(float deltaTime);
 };
 
 // Implementation section
-Game::Game() : jumpQueues{ JumpQueue(), JumpQueue(), JumpQueue() }, positionQueue(100), delayFrames(30), enemyCount(0), pauseMenu(font), isPaused(false), sharedHP(3), invincibilityTimer(0.0f), speedBoostTimer(0.0f), jumpBoostTimer(0.0f), currentLevel(1), initialTime(Time::Zero), currentSaveSlot(""), collectableCount(0), score(0), playerName("Player") {
+Game::Game(bool headless) : headless(headless), assetsFailed(false), cameraX(0.0f), cameraY(0.0f), delayFrames(30), enemyCount(0), enemyGrid(MAX_ENEMIES, CELL_SIZE), atlas(assets), font(assets.acquireFont("Data/arial.ttf")), pauseMenu(*font), isPaused(false), sharedHP(3), invincibilityTimer(0.0f), speedBoostTimer(0.0f), jumpBoostTimer(0.0f), currentLevel(1), initialTime(Time::Zero), currentSaveSlot(""), collectableCount(0), collectableGrid(MAX_COLLECTABLES, CELL_SIZE), score(0), playerName("Player"), seed(0), levelTextureCount(0), levelTextureBytes(0), nearbyOverflowLogged(false) {
     for (int i = 0; i < MAX_COLLECTABLES; ++i) collectables[i] = nullptr;
-    if (!wallTexture.loadFromFile("Data/brick1.png") ||
-        !backgroundTexture[0].loadFromFile("Data/background_level1.png") ||
-        !backgroundTexture[1].loadFromFile("Data/background_level2.png") ||
-        !backgroundTexture[2].loadFromFile("Data/background_level3.png") ||
-        !blockTexture.loadFromFile("Data/block.png") ||
-        !platformTexture.loadFromFile("Data/platform.png") ||
-        !crystalTexture.loadFromFile("Data/crystal.png") ||
-        !block3Texture.loadFromFile("Data/block3.png") ||
-        !spikeTexture.loadFromFile("Data/spik.png") ||
-        !pitTexture.loadFromFile("Data/pit.png") ||
-        !grassTexture.loadFromFile("Data/grass.png") ||
-        !block4Texture.loadFromFile("Data/block4.png") ||
-        !ringTexture.loadFromFile("Data/ring.png") ||
-        !extraLifeTexture.loadFromFile("Data/extralife.png") ||
-        !speedBoostTexture.loadFromFile("Data/speedboost.png") ||
-        !jumpBoostTexture.loadFromFile("Data/jumpboost.png") ||
-        !invincibilityBoostTexture.loadFromFile("Data/invincibilityboost.png") ||
-        !font.loadFromFile("Data/arial.ttf") ||
-        !backgroundMusic.openFromFile("Data/labrynth.ogg")) {
-        cout << "Failed to load assets.\n";
-        return;
-    }
-
-    if (!sonicIdleLeftTexture.loadFromFile("Data/0left_still.png") ||
-        !sonicIdleRightTexture.loadFromFile("Data/0right_still.png") ||
-        !sonicRunLeftTexture.loadFromFile("Data/sonic_runl.png") ||
-        !sonicRunRightTexture.loadFromFile("Data/sonic_runr.png") ||
-        !sonicJumpTexture.loadFromFile("Data/sonic_jump.png") ||
-        !sonicPushLeftTexture.loadFromFile("Data/sonic_pushl.png") ||
-        !sonicPushRightTexture.loadFromFile("Data/sonic_pushr.png") ||
-        !sonicEdgeLeftTexture.loadFromFile("Data/sonic_edgel.png") ||
-        !sonicEdgeRightTexture.loadFromFile("Data/sonic_edger.png") ||
-        !knucklesIdleLeftTexture.loadFromFile("Data/knuckles_idle_left.png") ||
-        !knucklesIdleRightTexture.loadFromFile("Data/knuckles_idle_right.png") ||
-        !knucklesRunLeftTexture.loadFromFile("Data/knuckles_run_left.png") ||
-        !knucklesRunRightTexture.loadFromFile("Data/knuckles_run_right.png") ||
-        !knucklesJumpLeftTexture.loadFromFile("Data/knuckles_jump_left.png") ||
-        !knucklesJumpRightTexture.loadFromFile("Data/knuckles_jump_right.png") ||
-        !knucklesPushLeftTexture.loadFromFile("Data/knuckles_push_left.png") ||
-        !knucklesPushRightTexture.loadFromFile("Data/knuckles_push_right.png") ||
-        !knucklesEdgeLeftTexture.loadFromFile("Data/knuckles_edge_left.png") ||
-        !knucklesEdgeRightTexture.loadFromFile("Data/knuckles_edge_right.png") ||
-        !knucklesPunchLeftTexture.loadFromFile("Data/knuckles_punch_left.png") ||
-        !knucklesPunchRightTexture.loadFromFile("Data/knuckles_punch_right.png") ||
-        !tailsIdleLeftTexture.loadFromFile("Data/tails_idle_left.png") ||
-        !tailsFlyLeftTexture.loadFromFile("Data/tails_fly_left.png") ||
-        !tailsFlyRightTexture.loadFromFile("Data/tails_fly_right.png") ||
-        !tailsIdleRightTexture.loadFromFile("Data/tails_idle_right.png") ||
-        !tailsRunLeftTexture.loadFromFile("Data/tails_run_left.png") ||
-        !tailsRunRightTexture.loadFromFile("Data/tails_run_right.png") ||
-        !tailsJumpTexture.loadFromFile("Data/tails_jump.png") ||
-        !tailsPushLeftTexture.loadFromFile("Data/tails_push_left.png") ||
-        !tailsPushRightTexture.loadFromFile("Data/tails_push_right.png") ||
-        !tailsEdgeLeftTexture.loadFromFile("Data/tails_edge_left.png") ||
-        !tailsEdgeRightTexture.loadFromFile("Data/tails_edge_right.png")) {
-        cout << "Failed to load character textures.\n";
+    for (int i = 0; i < MAX_ENEMIES; ++i) enemies[i] = nullptr;
+    for (int i = 0; i < 3; ++i) characters[i] = nullptr;
+    // Nothing ever closes a headless frame, so there is nothing to profile.
+    profiler.setEnabled(!headless);
+    // Headless games may still load assets (the benchmark does) but never draw them.
+    atlas.setUploads(!headless);
+
+    // Headless runs never open a window, so skip every texture, font and music
+    // file. Otherwise textures decode in the background while run() shows the
+    // loading screen, and the world is built once they are in.
+    if (!headless && !beginAssetLoading()) {
+        assetsFailed = true;
         return;
     }
 
-    if (!batBrainIdleLeftTexture.loadFromFile("Data/batbrain_idle_left.png") ||
-        !batBrainIdleRightTexture.loadFromFile("Data/batbrain_idle_right.png") ||
-        !batBrainMoveLeftTexture.loadFromFile("Data/batbrain_move_left.png") ||
-        !batBrainMoveRightTexture.loadFromFile("Data/batbrain_move_right.png") ||
-        !beeBotIdleLeftTexture.loadFromFile("Data/beebot_idle_left.png") ||
-        !beeBotIdleRightTexture.loadFromFile("Data/beebot_idle_right.png") ||
-        !beeBotMoveLeftTexture.loadFromFile("Data/beebot_move_left.png") ||
-        !beeBotMoveRightTexture.loadFromFile("Data/beebot_move_right.png") ||
-        !motobugIdleLeftTexture.loadFromFile("Data/motobug_idle_left.png") ||
-        !motobugIdleRightTexture.loadFromFile("Data/motobug_idle_right.png") ||
-        !motobugMoveLeftTexture.loadFromFile("Data/motobug_move_left.png") ||
-        !motobugMoveRightTexture.loadFromFile("Data/motobug_move_right.png") ||
-        !crabMeatIdleLeftTexture.loadFromFile("Data/crabmeat_idle_left.png") ||
-        !crabMeatIdleRightTexture.loadFromFile("Data/crabmeat_idle_right.png") ||
-        !crabMeatMoveLeftTexture.loadFromFile("Data/crabmeat_move_left.png") ||
-        !crabMeatMoveRightTexture.loadFromFile("Data/crabmeat_move_right.png") ||
-        !eggStingerIdleLeftTexture.loadFromFile("Data/eggstinger_idle_left.png") ||
-        !eggStingerIdleRightTexture.loadFromFile("Data/eggstinger_idle_right.png") ||
-        !eggStingerMoveLeftTexture.loadFromFile("Data/eggstinger_move_left.png") ||
-        !eggStingerMoveRightTexture.loadFromFile("Data/eggstinger_move_right.png")) {
-        cout << "Failed to load enemy textures.\n";
-        return;
-    }
-
-    for (int i = 0; i < MAX_ENEMIES; ++i) {
-        enemies[i] = nullptr;
-    }
-
-    backgroundSprite.setTexture(backgroundTexture[0]);
-    backgroundSprite.setScale(1.4f, 1.4f);
-    blockSprite.setTexture(blockTexture);
-    platformSprite.setTexture(platformTexture);
-    crystalSprite.setTexture(crystalTexture);
-    block3Sprite.setTexture(block3Texture);
-    block4Sprite.setTexture(block4Texture);
-    spikeSprite.setTexture(spikeTexture);
-    pitSprite.setTexture(pitTexture);
-    grassSprite.setTexture(grassTexture);
-    backgroundMusic.setLoop(true);
-    backgroundMusic.setVolume(30);
-    backgroundMusic.play();
-
-    timerText.setFont(font);
+    timerText.setFont(*font);
     timerText.setCharacterSize(20);
     timerText.setFillColor(Color::White);
     timerText.setPosition(10, 10);
 
-    gameTimerText.setFont(font);
+    gameTimerText.setFont(*font);
     gameTimerText.setCharacterSize(20);
     gameTimerText.setFillColor(Color::White);
     timerX = 10;
     timerY = 40;
     gameTimerText.setPosition(timerX, timerY);
 
-    scoreText.setFont(font);
+    scoreText.setFont(*font);
     scoreText.setCharacterSize(30);
     scoreText.setFillColor(Color::Yellow);
     scoreText.setPosition(10, 70);
 
-    hpText.setFont(font);
+    hpText.setFont(*font);
     hpText.setCharacterSize(20);
     hpText.setFillColor(Color::White);
     hpText.setPosition(10, 100);
 
+    if (headless) createWorld();
+}
+
+// Loads the default level and creates the characters. Needs the textures, so
+// a windowed game calls it only after the loading screen.
+void Game::createWorld() {
+    if (!headless) applyLoadedAssets();
+
     loadMap("Data/map.txt");
-    if (!level || rows <= 0 || cols <= 0) {
-        cout << "Failed to load valid level data.\n";
+    if (tiles.isEmpty()) {
+        LOG_ERROR("Failed to load valid level data.");
         return;
     }
+    loadLevelTextures(0, "", "Data/enemies.txt", "Data/collectables.txt");
+    setBackground(0);
     loadEnemies("Data/enemies.txt");
     loadCollectables("Data/collectables.txt");
 
-    levelWidth = cols * CELL_SIZE;
-    levelHeight = rows * CELL_SIZE;
+    levelWidth = tiles.getCols() * CELL_SIZE;
+    levelHeight = tiles.getRows() * CELL_SIZE;
 
     float sonicScale = 2.8f;
     float knucklesScale = 2.8f;
@@ -460,15 +500,253 @@ Game::Game() : jumpQueues{ JumpQueue(), JumpQueue(), JumpQueue() }, positionQueu
     updateDrawOrder();
 }
 
+// Queues the textures every level uses for decoding on the loader's threads
+// and loads the font and music, which are needed for the loading screen.
+// Textures become usable as showLoadingScreen() uploads them;
+// applyLoadedAssets() hooks them up. Backgrounds and enemy and collectable
+// sprites are only registered here and loaded per level.
+bool Game::beginAssetLoading() {
+    // Packed pages when data/atlas_packer has been run, loose images otherwise.
+    atlas.load("Data/atlas.txt");
+
+    if (!atlas.request("Data/brick1.png", wallTexture) ||
+        !atlas.request("Data/block.png", blockTexture) ||
+        !atlas.request("Data/platform.png", platformTexture) ||
+        !atlas.request("Data/crystal.png", crystalTexture) ||
+        !atlas.request("Data/block3.png", block3Texture) ||
+        !atlas.request("Data/spik.png", spikeTexture) ||
+        !atlas.request("Data/pit.png", pitTexture) ||
+        !atlas.request("Data/grass.png", grassTexture) ||
+        !atlas.request("Data/block4.png", block4Texture) ||
+        !font.load() ||
+        !backgroundMusic.openFromFile("Data/labrynth.ogg")) {
+        LOG_ERROR("Failed to queue assets.");
+        return false;
+    }
+
+    if (!atlas.request("Data/0left_still.png", sonicIdleLeftTexture) ||
+        !atlas.request("Data/0right_still.png", sonicIdleRightTexture) ||
+        !atlas.request("Data/sonic_runl.png", sonicRunLeftTexture) ||
+        !atlas.request("Data/sonic_runr.png", sonicRunRightTexture) ||
+        !atlas.request("Data/sonic_jump.png", sonicJumpTexture) ||
+        !atlas.request("Data/sonic_pushl.png", sonicPushLeftTexture) ||
+        !atlas.request("Data/sonic_pushr.png", sonicPushRightTexture) ||
+        !atlas.request("Data/sonic_edgel.png", sonicEdgeLeftTexture) ||
+        !atlas.request("Data/sonic_edger.png", sonicEdgeRightTexture) ||
+        !atlas.request("Data/knuckles_idle_left.png", knucklesIdleLeftTexture) ||
+        !atlas.request("Data/knuckles_idle_right.png", knucklesIdleRightTexture) ||
+        !atlas.request("Data/knuckles_run_left.png", knucklesRunLeftTexture) ||
+        !atlas.request("Data/knuckles_run_right.png", knucklesRunRightTexture) ||
+        !atlas.request("Data/knuckles_jump_left.png", knucklesJumpLeftTexture) ||
+        !atlas.request("Data/knuckles_jump_right.png", knucklesJumpRightTexture) ||
+        !atlas.request("Data/knuckles_push_left.png", knucklesPushLeftTexture) ||
+        !atlas.request("Data/knuckles_push_right.png", knucklesPushRightTexture) ||
+        !atlas.request("Data/knuckles_edge_left.png", knucklesEdgeLeftTexture) ||
+        !atlas.request("Data/knuckles_edge_right.png", knucklesEdgeRightTexture) ||
+        !atlas.request("Data/knuckles_punch_left.png", knucklesPunchLeftTexture) ||
+        !atlas.request("Data/knuckles_punch_right.png", knucklesPunchRightTexture) ||
+        !atlas.request("Data/tails_idle_left.png", tailsIdleLeftTexture) ||
+        !atlas.request("Data/tails_fly_left.png", tailsFlyLeftTexture) ||
+        !atlas.request("Data/tails_fly_right.png", tailsFlyRightTexture) ||
+        !atlas.request("Data/tails_idle_right.png", tailsIdleRightTexture) ||
+        !atlas.request("Data/tails_run_left.png", tailsRunLeftTexture) ||
+        !atlas.request("Data/tails_run_right.png", tailsRunRightTexture) ||
+        !atlas.request("Data/tails_jump.png", tailsJumpTexture) ||
+        !atlas.request("Data/tails_push_left.png", tailsPushLeftTexture) ||
+        !atlas.request("Data/tails_push_right.png", tailsPushRightTexture) ||
+        !atlas.request("Data/tails_edge_left.png", tailsEdgeLeftTexture) ||
+        !atlas.request("Data/tails_edge_right.png", tailsEdgeRightTexture)) {
+        LOG_ERROR("Failed to queue character textures.");
+        return false;
+    }
+
+    levelTextureCount = 0;
+    addLevelTexture("Data/background_level1.png", backgroundTexture[0]);
+    addLevelTexture("Data/background_level2.png", backgroundTexture[1]);
+    addLevelTexture("Data/background_level3.png", backgroundTexture[2]);
+    addLevelTexture("Data/batbrain_idle_left.png", batBrainIdleLeftTexture);
+    addLevelTexture("Data/batbrain_idle_right.png", batBrainIdleRightTexture);
+    addLevelTexture("Data/batbrain_move_left.png", batBrainMoveLeftTexture);
+    addLevelTexture("Data/batbrain_move_right.png", batBrainMoveRightTexture);
+    addLevelTexture("Data/beebot_idle_left.png", beeBotIdleLeftTexture);
+    addLevelTexture("Data/beebot_idle_right.png", beeBotIdleRightTexture);
+    addLevelTexture("Data/beebot_move_left.png", beeBotMoveLeftTexture);
+    addLevelTexture("Data/beebot_move_right.png", beeBotMoveRightTexture);
+    addLevelTexture("Data/motobug_idle_left.png", motobugIdleLeftTexture);
+    addLevelTexture("Data/motobug_idle_right.png", motobugIdleRightTexture);
+    addLevelTexture("Data/motobug_move_left.png", motobugMoveLeftTexture);
+    addLevelTexture("Data/motobug_move_right.png", motobugMoveRightTexture);
+    addLevelTexture("Data/crabmeat_idle_left.png", crabMeatIdleLeftTexture);
+    addLevelTexture("Data/crabmeat_idle_right.png", crabMeatIdleRightTexture);
+    addLevelTexture("Data/crabmeat_move_left.png", crabMeatMoveLeftTexture);
+    addLevelTexture("Data/crabmeat_move_right.png", crabMeatMoveRightTexture);
+    addLevelTexture("Data/eggstinger_idle_left.png", eggStingerIdleLeftTexture);
+    addLevelTexture("Data/eggstinger_idle_right.png", eggStingerIdleRightTexture);
+    addLevelTexture("Data/eggstinger_move_left.png", eggStingerMoveLeftTexture);
+    addLevelTexture("Data/eggstinger_move_right.png", eggStingerMoveRightTexture);
+    addLevelTexture("Data/ring.png", ringTexture);
+    addLevelTexture("Data/extralife.png", extraLifeTexture);
+    addLevelTexture("Data/speedboost.png", speedBoostTexture);
+    addLevelTexture("Data/jumpboost.png", jumpBoostTexture);
+    addLevelTexture("Data/invincibilityboost.png", invincibilityBoostTexture);
+
+    return true;
+}
+
+// Pumps texture uploads while drawing a progress bar; returns false if the
+// window was closed or an asset failed to load.
+bool Game::showLoadingScreen(RenderWindow& window) {
+    if (assetsFailed) return false;
+    const float barWidth = 600.0f;
+    RectangleShape barBack(Vector2f(barWidth, 24.0f));
+    barBack.setPosition((SCREEN_X - barWidth) / 2.0f, SCREEN_Y / 2.0f);
+    barBack.setFillColor(Color(60, 60, 60));
+    RectangleShape bar(Vector2f(0.0f, 24.0f));
+    bar.setPosition(barBack.getPosition());
+    bar.setFillColor(Color(40, 120, 255));
+    Text label("Loading...", *font, 30);
+    label.setPosition((SCREEN_X - barWidth) / 2.0f, SCREEN_Y / 2.0f - 50.0f);
+
+    bool finished = false;
+    while (!finished) {
+        Event ev;
+        while (window.pollEvent(ev)) {
+            if (ev.type == Event::Closed) {
+                window.close();
+                return false;
+            }
+        }
+        finished = atlas.update();
+        bar.setSize(Vector2f(barWidth * atlas.getProgress(), 24.0f));
+
+        window.clear(Color::Black);
+        window.draw(barBack);
+        window.draw(bar);
+        window.draw(label);
+        window.display();
+    }
+
+    if (atlas.hasFailed()) {
+        LOG_ERROR("Failed to load assets.");
+        return false;
+    }
+    LOG_INFO("Loaded %d texture pages in %d ms", atlas.getResidentPageCount(), startupClock.getElapsedTime().asMilliseconds());
+    return true;
+}
+
+void Game::addLevelTexture(const char* file, SpriteSheet& sheet) {
+    levelTextureFiles[levelTextureCount] = file;
+    levelTextureSheets[levelTextureCount] = &sheet;
+    levelTextureResident[levelTextureCount] = false;
+    levelTextureCount++;
+}
+
+void Game::markEnemyTextures(char type, bool* needed) const {
+    const char* kinds = "BEMCS";
+    const char* kind = type ? strchr(kinds, type) : nullptr;
+    if (!kind) return;
+    int first = BACKGROUND_COUNT + static_cast<int>(kind - kinds) * 4;
+    for (int i = 0; i < 4; ++i) needed[first + i] = true;
+}
+
+void Game::markCollectableTexture(char type, bool* needed) const {
+    const char* kinds = "RESJI";
+    const char* kind = type ? strchr(kinds, type) : nullptr;
+    if (kind) needed[BACKGROUND_COUNT + ENEMY_KINDS * 4 + static_cast<int>(kind - kinds)] = true;
+}
+
+// Marks the textures a level's entities use without creating any: from the
+// compiled level if there is one, from the text manifests otherwise.
+void Game::scanLevelTextures(const string& levelFile, const string& enemiesFile, const string& collectablesFile, bool* needed) const {
+    MappedFile blob;
+    const LevelHeader* header = blob.open(levelFile) ? validateLevelBlob(blob.data(), blob.size()) : nullptr;
+    if (header) {
+        const LevelEntity* entities = levelEnemies(blob.data());
+        for (uint32_t i = 0; i < header->enemyCount; ++i) markEnemyTextures(entities[i].type, needed);
+        entities = levelCollectables(blob.data());
+        for (uint32_t i = 0; i < header->collectableCount; ++i) markCollectableTexture(entities[i].type, needed);
+        return;
+    }
+
+    char type;
+    float x, y;
+    ifstream enemiesIn(enemiesFile);
+    while (enemiesIn >> type >> x >> y) {
+        enemiesIn.ignore(numeric_limits<streamsize>::max(), '\n');
+        markEnemyTextures(type, needed);
+    }
+    ifstream collectablesIn(collectablesFile);
+    while (collectablesIn >> type >> x >> y) {
+        collectablesIn.ignore(numeric_limits<streamsize>::max(), '\n');
+        markCollectableTexture(type, needed);
+    }
+}
+
+// Makes a level's background and the sprites of its entity types resident.
+// Headless runs have nothing registered and skip the scan.
+void Game::loadLevelTextures(int background, const string& levelFile, const string& enemiesFile, const string& collectablesFile) {
+    if (levelTextureCount == 0) return;
+    bool needed[LEVEL_TEXTURES] = {};
+    needed[background] = true;
+    scanLevelTextures(levelFile, enemiesFile, collectablesFile, needed);
+    retainLevelTextures(needed);
+}
+
+// Keeps exactly the level textures marked in needed: releases the others, lets
+// the cache free the pages no longer in use, then loads what is missing. Waits
+// for the uploads, since entities copy their textures when they are built.
+void Game::retainLevelTextures(const bool* needed) {
+    if (levelTextureCount == 0) return;
+    for (int i = 0; i < levelTextureCount; ++i) {
+        if (levelTextureResident[i] && !needed[i]) {
+            atlas.release(levelTextureFiles[i], *levelTextureSheets[i]);
+            levelTextureResident[i] = false;
+        }
+    }
+    int evicted = assets.evictUnused();
+
+    for (int i = 0; i < levelTextureCount; ++i) {
+        if (needed[i] && !levelTextureResident[i]) {
+            if (atlas.request(levelTextureFiles[i], *levelTextureSheets[i])) levelTextureResident[i] = true;
+            else LOG_ERROR("Failed to queue %s", levelTextureFiles[i]);
+        }
+    }
+    atlas.finish();
+
+    levelTextureBytes = atlas.getResidentBytes();
+    LOG_INFO("Level textures: evicted %d, %d pages resident, %d KB.", evicted, atlas.getResidentPageCount(), static_cast<int>(levelTextureBytes / 1024));
+}
+
+void Game::setBackground(int index) {
+    backgroundSprite.setTexture(*backgroundTexture[index].texture);
+    backgroundSprite.setTextureRect(backgroundTexture[index].rect);
+    backgroundSprite.setScale(1.4f, 1.4f);
+}
+
+void Game::applyLoadedAssets() {
+    tileMap.setTexture(TileMap::Wall, wallTexture);
+    tileMap.setTexture(TileMap::Block, blockTexture);
+    tileMap.setTexture(TileMap::Platform, platformTexture);
+    tileMap.setTexture(TileMap::Crystal, crystalTexture);
+    tileMap.setTexture(TileMap::Block3, block3Texture);
+    tileMap.setTexture(TileMap::Block4, block4Texture);
+    tileMap.setTexture(TileMap::Spike, spikeTexture);
+    tileMap.setTexture(TileMap::Pit, pitTexture);
+    tileMap.setTexture(TileMap::Grass, grassTexture);
+    backgroundMusic.setLoop(true);
+    backgroundMusic.setVolume(30);
+    backgroundMusic.play();
+}
+
 Game::~Game() {
+    if (!headless && profiler.hasTrace() && !profiler.writeTrace("profile_trace.json")) {
+        LOG_ERROR("PROFILER ERROR: Could not write profile_trace.json");
+    }
     for (int i = 0; i < 3; ++i) delete characters[i];
-    for (int i = 0; i < rows; ++i) delete[] mapData[i];
-    delete[] mapData;
-    for (int i = 0; i < enemyCount; ++i) delete enemies[i];
-    for (int i = 0; i < collectableCount; ++i) delete collectables[i];
+    releaseEntities();
 }
 
-void Game::checkCharacterRespawn(float cameraX, float cameraY) {
+void Game::checkCharacterRespawn(float cameraX, float cameraY, float deltaTime) {
     for (int i = 0; i < 3; ++i) {
         float charX = characters[i]->getPosX();
         float charY = characters[i]->getPosY();
@@ -483,7 +761,7 @@ void Game::checkCharacterRespawn(float cameraX, float cameraY) {
             characters[i]->setVelY(0.0f);
             characters[i]->setOnGround(true);
             offScreenTimers[i] = 0.0f;
-            cout << "Character " << i << " respawned due to falling below map.\n";
+            LOG_INFO("Character %d respawned due to falling below map.", i);
             continue;
         }
 
@@ -497,7 +775,7 @@ void Game::checkCharacterRespawn(float cameraX, float cameraY) {
                 charY >= screenTop && charY <= screenBottom);
 
             if (!isOnScreen) {
-                offScreenTimers[i] += 1.0f / 60.0f;
+                offScreenTimers[i] += deltaTime;
                 if (offScreenTimers[i] >= 4.0f) {
                     characters[i]->setPosX(characters[mainIndex]->getPosX() - 1200.0f);
                     characters[i]->setPosY(characters[mainIndex]->getPosY());
@@ -505,7 +783,7 @@ void Game::checkCharacterRespawn(float cameraX, float cameraY) {
                     characters[i]->setVelY(0.0f);
                     characters[i]->setOnGround(true);
                     offScreenTimers[i] = 0.0f;
-                    cout << "Follower " << i << " respawned due to being stuck off-screen.\n";
+                    LOG_INFO("Follower %d respawned due to being stuck off-screen.", i);
                 }
             }
             else {
@@ -527,13 +805,11 @@ void Game::respawnCharacter(int charIndex, bool isMain) {
 
     for (int y = row - 1; y >= 0 && !found; --y) {
         for (int x = col - 2; x <= col + 2; ++x) {
-            if (x >= 0 && x < cols && y >= 0 && y < rows) {
-                if (mapData[y][x] == 'b' || mapData[y][x] == 'p') {
-                    newX = x * CELL_SIZE + CELL_SIZE / 2.0f;
-                    newY = y * CELL_SIZE - characters[charIndex]->getHeight() - 64.0f;
-                    found = true;
-                    break;
-                }
+            if (tiles.contains(x, y) && tileHas(tiles.at(x, y), TILE_FLOOR)) {
+                newX = x * CELL_SIZE + CELL_SIZE / 2.0f;
+                newY = y * CELL_SIZE - characters[charIndex]->getHeight() - 64.0f;
+                found = true;
+                break;
             }
         }
     }
@@ -550,9 +826,9 @@ void Game::respawnCharacter(int charIndex, bool isMain) {
     characters[charIndex]->setOnGround(true);
 }
 
-void Game::checkHazardCollisions(int& sharedHP, float& invincibilityTimer) {
+void Game::checkHazardCollisions(int& sharedHP, float& invincibilityTimer, float deltaTime) {
     if (invincibilityTimer > 0.0f) {
-        invincibilityTimer -= 1.0f / 60.0f;
+        invincibilityTimer -= deltaTime;
         return;
     }
 
@@ -570,31 +846,31 @@ void Game::checkHazardCollisions(int& sharedHP, float& invincibilityTimer) {
 
         for (int y = topRow; y <= botRow; ++y) {
             for (int x = leftCol; x <= rightCol; ++x) {
-                if (x >= 0 && x < cols && y >= 0 && y < rows) {
-                    char tile = level[y][x];
-                    if (tile == 'u') {
+                if (tiles.contains(x, y)) {
+                    char tile = tiles.at(x, y);
+                    if (tileHas(tile, TILE_HAZARD)) {
                         if (isMain) {
-                            cout << "Fall on spike\n";
+                            LOG_INFO("Fall on spike");
                             this->sharedHP--;
                             this->invincibilityTimer = 1.0f;
-                            cout << "Player HP: " << sharedHP << "\n";
+                            LOG_INFO("Player HP: %d", sharedHP);
                             if (this->sharedHP <= 0) {
-                                cout << "Game Over!\n";
+                                LOG_INFO("Game Over!");
                             }
                         }
                         else {
-                            cout << "Follower collides on spike\n";
+                            LOG_INFO("Follower collides on spike");
                         }
                         respawnCharacter(i, isMain);
                         return;
                     }
-                    else if (tile == 'x') {
+                    else if (tileHas(tile, TILE_PIT)) {
                         if (isMain) {
-                            cout << "Game Over\n";
+                            LOG_INFO("Game Over");
                             this->sharedHP = 0;
                         }
                         else {
-                            cout << "Follower falls in pit\n";
+                            LOG_INFO("Follower falls in pit");
                         }
                         respawnCharacter(i, isMain);
                         return;
@@ -608,36 +884,55 @@ void Game::checkHazardCollisions(int& sharedHP, float& invincibilityTimer) {
 void Game::run() {
     RenderWindow window(VideoMode(SCREEN_X, SCREEN_Y), "Sonic Platformer", Style::Close);
     window.setFramerateLimit(60);
-    Menu menu(font, backgroundMusic);
-    int action = menu.run(window);
-
-    if (action == Menu::EXIT) {
-        window.close();
-        return;
-    }
-
-    if (action == Menu::START_GAME) {
-        currentSaveSlot = "Slot 1";
-        int selectedLevel = menu.getSelectedLevel();
-        initializeLevel(selectedLevel);
-        char playerNameTemp[32];
-        menu.getPlayerName(window, playerNameTemp); // Get player name again if needed
-        playerName = string(playerNameTemp);
-    }
-    else if (action == Menu::LOAD_GAME) {
-        currentSaveSlot = menu.getSelectedSaveSlot();
-        string filename = "save_" + currentSaveSlot.substr(5) + ".txt";
-        loadGame(filename);
+    if (!showLoadingScreen(window)) return;
+    createWorld();
+    Menu menu(assets, *font, backgroundMusic);
+    LOG_INFO("First menu frame %d ms after startup", startupClock.getElapsedTime().asMilliseconds());
+
+    // A replay skips the menu and feeds every simulation step from the log.
+    ReplayInput replay;
+    bool replaying = false;
+    if (!replayPath.empty()) {
+        if (!replay.open(replayPath)) {
+            LOG_ERROR("REPLAY ERROR: Could not open %s", replayPath.c_str());
+            return;
+        }
+        replaying = true;
+        seed = replay.getSeed();
+        srand(seed);
+        if (!initializeLevel(replay.getLevel())) return;
+        setMainCharacter(replay.getMainIndex());
     }
     else {
-        return;
+        int action = menu.run(window);
+
+        if (action == Menu::EXIT) {
+            window.close();
+            return;
+        }
+
+        if (action == Menu::START_GAME) {
+            currentSaveSlot = "Slot 1";
+            int selectedLevel = menu.getSelectedLevel();
+            if (!initializeLevel(selectedLevel)) return;
+            startRecording();
+            char playerNameTemp[32];
+            menu.getPlayerName(window, playerNameTemp); // Get player name again if needed
+            playerName = string(playerNameTemp);
+        }
+        else if (action == Menu::LOAD_GAME) {
+            currentSaveSlot = menu.getSelectedSaveSlot();
+            string filename = "save_" + currentSaveSlot.substr(5) + ".txt";
+            loadGame(filename);
+        }
+        else {
+            return;
+        }
     }
 
-    Sprite wallSprite(wallTexture);
-    const float gravity = 3.0f;
-    const float terminalVel = 19.0f;
-    const float jumpStrength = -26.0f;
     Clock clock;
+    float accumulator = 0.0f;
+    bool switchRequested = false;
 
     while (window.isOpen()) {
         Event ev;
@@ -666,63 +961,50 @@ void Game::run() {
                 }
             }
             else if (!isPaused && ev.type == Event::KeyPressed && ev.key.code == Keyboard::A) {
-                for (int idx = 0; idx < 3; ++idx) {
-                    characters[idx]->currentMaxSpeed = characters[idx]->getBaseMaxSpeed();
-                }
-                mainIndex = (mainIndex + 1) % 3;
-                characters[mainIndex]->currentMaxSpeed = characters[mainIndex]->getBaseMaxSpeed() * 1.2f;
-                updateDrawOrder();
+                switchRequested = true;
+            }
+            else if (ev.type == Event::KeyPressed && ev.key.code == Keyboard::F3) {
+                profiler.toggleOverlay();
             }
         }
 
-        float deltaTime = clock.restart().asSeconds();
+        float frameTime = clock.restart().asSeconds();
+        accumulator += frameTime;
+        if (accumulator > MAX_STEPS_PER_FRAME * FIXED_TIMESTEP) accumulator = MAX_STEPS_PER_FRAME * FIXED_TIMESTEP;
 
-        positionQueue.enqueue(characters[mainIndex]->getPosX(), characters[mainIndex]->getPosY());
-        while (positionQueue.size > delayFrames) positionQueue.dequeue();
-
-        characters[mainIndex]->update(gravity, terminalVel, jumpStrength, level, rows, cols, deltaTime);
+        InputState input;
+        {
+            ScopedTimer timer(profiler, Profiler::Input);
+            input = keyboardInput.poll();
+        }
 
-        if (characters[mainIndex]->justJumped) {
-            float xPos = characters[mainIndex]->getPosX();
-            for (int i = 0; i < 3; ++i) {
-                if (i != mainIndex) jumpQueues[i].enqueue(xPos);
+        long long simulationStart = profiler.now();
+        while (accumulator >= FIXED_TIMESTEP && sharedHP > 0) {
+            InputState stepInput = input;
+            if (replaying) {
+                if (replay.isFinished()) break;
+                stepInput = replay.poll();
             }
-        }
-        for (int i = 0; i < 3; ++i) {
-            if (Knuckles* knuckles = dynamic_cast<Knuckles*>(characters[i])) {
-                for (int j = 0; j < knuckles->numBlocksToBreak; ++j) {
-                    int x = knuckles->blocksToBreak[j].x;
-                    int y = knuckles->blocksToBreak[j].y;
-                    if (x >= 0 && x < cols && y >= 0 && y < rows) {
-                        mapData[y][x] = ' ';
-                    }
-                }
-                knuckles->numBlocksToBreak = 0;
+            else {
+                // The switch is a key press, so it only applies to the first step of the frame.
+                stepInput.switchCharacter = switchRequested;
+                switchRequested = false;
             }
+            simulateFrame(FIXED_TIMESTEP, stepInput);
+            accumulator -= FIXED_TIMESTEP;
         }
+        profiler.addSpan(Profiler::Simulation, simulationStart, profiler.now());
 
-        for (int i = 0; i < 3; ++i) {
-            if (i != mainIndex) {
-                PositionQueue::Position targetPos = positionQueue.isEmpty() ?
-                    PositionQueue::Position{ characters[mainIndex]->getPosX(), characters[mainIndex]->getPosY() } :
-                    positionQueue.peek();
-                characters[i]->updateFollower(gravity, terminalVel, jumpStrength, level, rows, cols, deltaTime,
-                    targetPos.x, targetPos.y, jumpQueues[i]);
-            }
+        if (replaying && replay.isFinished()) {
+            LOG_INFO("Replay finished. Score: %d", score);
+            window.close();
+            return;
         }
 
-        for (int i = 0; i < 3; ++i) characters[i]->jumpedWhileStillThisFrame = false;
-
-        updateEnemies(deltaTime, gravity, terminalVel);
-        checkCollisions();
-        checkHazardCollisions(sharedHP, invincibilityTimer);
-
-        updateCollectables();
-        updateBoosts(deltaTime);
-
         if (sharedHP <= 0) {
+            recorder.finish();
             menu.updateScoreboard(playerName.c_str(), score);
-            action = menu.run(window);
+            int action = menu.run(window);
             if (action == Menu::EXIT) {
                 window.close();
                 return;
@@ -730,7 +1012,8 @@ void Game::run() {
             else if (action == Menu::START_GAME) {
                 currentSaveSlot = "Slot 1";
                 int selectedLevel = menu.getSelectedLevel();
-                initializeLevel(selectedLevel);
+                if (!initializeLevel(selectedLevel)) return;
+                startRecording();
                 char playerNameTemp[32];
                 menu.getPlayerName(window, playerNameTemp);
                 playerName = string(playerNameTemp);
@@ -740,6 +1023,8 @@ void Game::run() {
                 string filename = "save_" + currentSaveSlot.substr(5) + ".txt";
                 loadGame(filename);
             }
+            accumulator = 0.0f;
+            clock.restart();
             continue;
         }
 
@@ -755,88 +1040,287 @@ void Game::run() {
         scoreText.setString("Score: " + to_string(score));
         hpText.setString("HP: " + to_string(sharedHP));
 
-        float centerX = characters[mainIndex]->getPosX();
-        float centerY = characters[mainIndex]->getPosY();
-        float idealCameraX = centerX - SCREEN_X / 2.0f;
-        float idealCameraY = centerY - SCREEN_Y / 2.0f;
-
-        float cameraX, cameraY;
-        if (levelWidth < SCREEN_X) cameraX = -(SCREEN_X - levelWidth) / 2.0f;
-        else cameraX = max(0.0f, min(idealCameraX, levelWidth - SCREEN_X));
-        if (levelHeight < SCREEN_Y) cameraY = -(SCREEN_Y - levelHeight) / 2.0f;
-        else cameraY = max(0.0f, min(idealCameraY, levelHeight - SCREEN_Y));
-
-        checkCharacterRespawn(cameraX, cameraY);
+        float alpha = accumulator / FIXED_TIMESTEP;
+        updateCamera(alpha);
 
         RenderStates states;
         states.transform.translate(-cameraX, -cameraY);
 
-        window.clear();
-        window.draw(backgroundSprite);
-        drawLevel(window, wallSprite, states);
-        for (int i = 0; i < 3; ++i) characters[drawOrder[i]]->draw(window, states);
-        drawEnemies(window, states);
-        drawCollectables(window, states);
-        window.draw(timerText);
-        window.draw(gameTimerText);
-        window.draw(scoreText);
-        window.draw(hpText);
-        window.display();
+        // Tiles are drawn at their texture size, which can spill past their cell,
+        // so keep a margin of a couple of cells around the screen.
+        const float cullMargin = 2.0f * CELL_SIZE;
+        FloatRect visibleArea(cameraX - cullMargin, cameraY - cullMargin,
+            SCREEN_X + 2.0f * cullMargin, SCREEN_Y + 2.0f * cullMargin);
+
+        {
+            ScopedTimer timer(profiler, Profiler::DrawLevel);
+            window.clear();
+            window.draw(backgroundSprite);
+            drawLevel(window, states, visibleArea);
+        }
+        {
+            ScopedTimer timer(profiler, Profiler::DrawCharacters);
+            for (int i = 0; i < 3; ++i) characters[drawOrder[i]]->draw(window, states, alpha);
+        }
+        {
+            ScopedTimer timer(profiler, Profiler::DrawEnemies);
+            drawEnemies(window, states, visibleArea, alpha);
+        }
+        {
+            ScopedTimer timer(profiler, Profiler::DrawCollectables);
+            drawCollectables(window, states, visibleArea);
+        }
+        {
+            ScopedTimer timer(profiler, Profiler::DrawHud);
+            window.draw(timerText);
+            window.draw(gameTimerText);
+            window.draw(scoreText);
+            window.draw(hpText);
+            profiler.drawOverlay(window, *font);
+        }
+        {
+            ScopedTimer timer(profiler, Profiler::Display);
+            window.display();
+        }
+        profiler.endFrame();
+    }
+}
+
+void Game::simulateFrame(float deltaTime, const InputState& input) {
+    const float gravity = 3.0f;
+    const float terminalVel = 19.0f;
+    const float jumpStrength = -26.0f;
+
+    recorder.record(input);
+    if (input.switchCharacter) setMainCharacter((mainIndex + 1) % 3);
+
+    streamLevel();
+    for (int i = 0; i < 3; ++i) characters[i]->storePreviousPosition();
+
+    positionQueue.enqueue(TrailPosition{ characters[mainIndex]->getPosX(), characters[mainIndex]->getPosY() });
+    while (positionQueue.getSize() > delayFrames) positionQueue.dequeue();
+
+    {
+        ScopedTimer timer(profiler, Profiler::MainUpdate);
+        characters[mainIndex]->update(gravity, terminalVel, jumpStrength, tiles, deltaTime, input);
+
+        if (characters[mainIndex]->justJumped) {
+            float xPos = characters[mainIndex]->getPosX();
+            for (int i = 0; i < 3; ++i) {
+                if (i != mainIndex) jumpQueues[i].enqueue(xPos);
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (Knuckles* knuckles = dynamic_cast<Knuckles*>(characters[i])) {
+                for (int j = 0; j < knuckles->numBlocksToBreak; ++j) {
+                    int x = knuckles->blocksToBreak[j].x;
+                    int y = knuckles->blocksToBreak[j].y;
+                    if (tiles.contains(x, y)) {
+                        tiles.set(x, y, TileGrid::EMPTY);
+                        levelStream.markEdited(x);
+                        navGraph.patchCell(tiles, x, y);
+                        pathFinder.clear();
+                        if (!headless) tileMap.updateCell(tiles, x, y);
+                    }
+                }
+                knuckles->numBlocksToBreak = 0;
+            }
+        }
+    }
+
+    {
+        ScopedTimer timer(profiler, Profiler::Followers);
+        pathFinder.update(tiles);
+        for (int i = 0; i < 3; ++i) {
+            if (i != mainIndex) {
+                TrailPosition targetPos = positionQueue.isEmpty() ?
+                    TrailPosition{ characters[mainIndex]->getPosX(), characters[mainIndex]->getPosY() } :
+                    positionQueue.peek();
+                characters[i]->updateFollower(gravity, terminalVel, jumpStrength, tiles, navGraph, pathFinder, deltaTime,
+                    targetPos.x, targetPos.y, jumpQueues[i], input);
+            }
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) characters[i]->jumpedWhileStillThisFrame = false;
+
+    {
+        ScopedTimer timer(profiler, Profiler::Enemies);
+        updateEnemies(deltaTime, gravity, terminalVel);
+    }
+    {
+        ScopedTimer timer(profiler, Profiler::Collisions);
+        checkCollisions(deltaTime);
+    }
+    {
+        ScopedTimer timer(profiler, Profiler::Hazards);
+        checkHazardCollisions(sharedHP, invincibilityTimer, deltaTime);
+    }
+    {
+        ScopedTimer timer(profiler, Profiler::Collectables);
+        updateCollectables();
+        updateBoosts(deltaTime);
+    }
+
+    if (sharedHP > 0) {
+        updateCamera();
+        checkCharacterRespawn(cameraX, cameraY, deltaTime);
+    }
+}
+
+// Keeps the streamed window centred on the main character. Runs at the start
+// of a step, so everything simulated this step sees the same resident tiles.
+void Game::streamLevel() {
+    int centerCol = static_cast<int>(characters[mainIndex]->getPosX()) / CELL_SIZE;
+    if (levelStream.update(tiles, centerCol)) {
+        navGraph.build(tiles);
+        pathFinder.clear();
+        if (!headless) tileMap.build(tiles, CELL_SIZE);
     }
 }
 
-void Game::initializeLevel(int level) {
+void Game::updateCamera(float alpha) {
+    float centerX = characters[mainIndex]->getRenderX(alpha);
+    float centerY = characters[mainIndex]->getRenderY(alpha);
+    float idealCameraX = centerX - SCREEN_X / 2.0f;
+    float idealCameraY = centerY - SCREEN_Y / 2.0f;
+
+    if (levelWidth < SCREEN_X) cameraX = -(SCREEN_X - levelWidth) / 2.0f;
+    else cameraX = max(0.0f, min(idealCameraX, levelWidth - SCREEN_X));
+    if (levelHeight < SCREEN_Y) cameraY = -(SCREEN_Y - levelHeight) / 2.0f;
+    else cameraY = max(0.0f, min(idealCameraY, levelHeight - SCREEN_Y));
+}
+
+// Drives the same update pipeline as run() without a window: no rendering,
+// no frame limit, and controls come from the injected input source.
+int Game::runHeadless(InputSource& input, int level, int maxFrames) {
+    if (!initializeLevel(level)) return 0;
+    setMainCharacter(0);
+    startRecording();
+
+    int frame = 0;
+    while (frame < maxFrames && sharedHP > 0) {
+        simulateFrame(FIXED_TIMESTEP, input.poll());
+        frame++;
+    }
+    recorder.finish();
+    return frame;
+}
+
+// Re-drives a recorded log headlessly; returns the number of steps played.
+int Game::runReplay(const string& filename) {
+    ReplayInput replay;
+    if (!replay.open(filename)) {
+        LOG_ERROR("REPLAY ERROR: Could not open %s", filename.c_str());
+        return 0;
+    }
+    seed = replay.getSeed();
+    srand(seed);
+    if (!initializeLevel(replay.getLevel())) return 0;
+    setMainCharacter(replay.getMainIndex());
+
+    int frame = 0;
+    while (!replay.isFinished() && sharedHP > 0) {
+        simulateFrame(FIXED_TIMESTEP, replay.poll());
+        frame++;
+    }
+    return frame;
+}
+
+void Game::setMainCharacter(int index) {
+    for (int i = 0; i < 3; ++i) {
+        characters[i]->currentMaxSpeed = characters[i]->getBaseMaxSpeed();
+    }
+    mainIndex = index;
+    characters[mainIndex]->currentMaxSpeed = characters[mainIndex]->getBaseMaxSpeed() * 1.2f;
+    updateDrawOrder();
+}
+
+void Game::startRecording() {
+    if (recordPath.empty()) return;
+    seed = static_cast<unsigned int>(time(nullptr));
+    srand(seed);
+    if (!recorder.begin(recordPath, currentLevel, seed, mainIndex)) {
+        LOG_ERROR("REPLAY ERROR: Could not write %s", recordPath.c_str());
+    }
+}
+
+// False, with nothing loaded, if the level's data is missing or invalid.
+bool Game::initializeLevel(int level) {
     currentLevel = level;
     string mapFile = "Data/map_" + to_string(level) + ".txt";
+    string chunkFile = "Data/map_" + to_string(level) + ".chunks";
+    string levelFile = "Data/level_" + to_string(level) + ".bin";
     string enemiesFile = "Data/enemies_" + to_string(level) + ".txt";
     string collectablesFile = "Data/collectables_" + to_string(level) + ".txt";
-    if (mapData) {
-        for (int i = 0; i < rows; ++i) delete[] mapData[i];
-        delete[] mapData;
+    levelStream.close();
+    tiles.clear();
+    levelMapping.close();
+    releaseEntities();
+
+    // The old level's entities are gone, so its textures can be swapped for
+    // the ones this level uses.
+    int background = levelBackground(level);
+    loadLevelTextures(background, levelFile, enemiesFile, collectablesFile);
+
+    // Tiles come from the chunked form if there is one (it streams), otherwise
+    // from the compiled blob, which also carries the entities. The text files
+    // are only read with LEVEL_TEXT_FALLBACK.
+    bool streamed = levelStream.open(chunkFile, tiles);
+    if (streamed) {
+        navGraph.build(tiles);
+        pathFinder.clear();
+        if (!headless) tileMap.build(tiles, CELL_SIZE);
     }
-    for (int i = 0; i < enemyCount; ++i) delete enemies[i];
-    enemyCount = 0;
-    for (int i = 0; i < collectableCount; ++i) delete collectables[i];
-    for (int i = 0; i < MAX_COLLECTABLES; ++i) collectables[i] = nullptr;
-    collectableCount = 0;
-
-    loadMap(mapFile);
-    if (!level || rows <= 0 || cols <= 0) {
-        cout << "Failed to load valid level data for level " << level << ".\n";
-        loadMap("Data/map.txt");
-        loadEnemies("Data/enemies.txt");
-        loadCollectables("Data/collectables.txt");
-        backgroundSprite.setTexture(backgroundTexture[0]);
-        return;
+    bool compiled = loadCompiledLevel(levelFile, !streamed);
+    if (!compiled) {
+#if LEVEL_TEXT_FALLBACK
+        if (tiles.isEmpty()) loadMap(mapFile);
+#else
+        LOG_ERROR("LEVEL ERROR: No compiled level %s", levelFile.c_str());
+        levelStream.close();
+        tiles.clear();
+#endif
     }
-    loadEnemies(enemiesFile);
-    loadCollectables(collectablesFile);
-
-    if (level >= 1 && level <= 3) {
-        backgroundSprite.setTexture(backgroundTexture[level - 1]);
-        backgroundSprite.setScale(1.4f, 1.4f);
+    if (tiles.isEmpty()) {
+        LOG_ERROR("Failed to load valid level data for level %d.", level);
+        return false;
     }
-    else {
-        backgroundSprite.setTexture(backgroundTexture[0]);
-        backgroundSprite.setScale(1.4f, 1.4f);
+    if (!compiled) {
+        loadEnemies(enemiesFile);
+        loadCollectables(collectablesFile);
     }
 
-    levelWidth = cols * CELL_SIZE;
-    levelHeight = rows * CELL_SIZE;
+    setBackground(background);
+
+    levelWidth = tiles.getCols() * CELL_SIZE;
+    levelHeight = tiles.getRows() * CELL_SIZE;
 
     startX = CELL_SIZE * 1.0f;
     startY = CELL_SIZE * 11.1f;
     for (int i = 0; i < 3; ++i) {
         characters[i]->setPosX(startX);
         characters[i]->setPosY(startY);
-        characters[i]->setVelX(0.0f);
-        characters[i]->setVelY(0.0f);
+        characters[i]->resetState();
         characters[i]->setOnGround(true);
     }
+    // Puts the speeds back to base, including a speed boost still running
+    // when the last game ended.
+    setMainCharacter(mainIndex);
     score = 0;
+    sharedHP = 3;
     speedBoostTimer = 0.0f;
     jumpBoostTimer = 0.0f;
     invincibilityTimer = 0.0f;
+
+    // Everything the simulation carries between steps starts fresh so replays line up.
+    positionQueue.clear();
+    for (int i = 0; i < 3; ++i) {
+        jumpQueues[i].clear();
+        offScreenTimers[i] = 0.0f;
+        hitInvincibilityTimers[i] = 0.0f;
+    }
+    return true;
 }
 
 void Game::updateDrawOrder() {
@@ -850,42 +1334,73 @@ void Game::updateDrawOrder() {
 void Game::loadMap(const string& filename) {
     ifstream in(filename);
     if (!in.is_open()) {
-        cout << "MAP ERROR: Could not open " << filename << "\n";
+        LOG_ERROR("MAP ERROR: Could not open %s", filename.c_str());
         return;
     }
 
+    int rows, cols;
     in >> rows >> cols;
     if (rows <= 0 || cols <= 0) {
-        cout << "MAP ERROR: Invalid dimensions (" << rows << "x" << cols << ")\n";
+        LOG_ERROR("MAP ERROR: Invalid dimensions (%dx%d)", rows, cols);
         in.close();
         return;
     }
 
-    mapData = new char* [rows];
-    for (int i = 0; i < rows; ++i) {
-        mapData[i] = new char[cols];
-        for (int j = 0; j < cols; ++j) mapData[i][j] = ' ';
-    }
+    tiles.resize(rows, cols);
 
     in.ignore(numeric_limits<streamsize>::max(), '\n');
     string line;
     int y = 0;
     while (y < rows && getline(in, line)) {
         if (line.empty()) continue;
-        for (int x = 0; x < cols && x < line.length(); ++x) {
-            mapData[y][x] = line[x];
-        }
+        line.copy(tiles.rowData(y), cols);
         y++;
     }
 
     in.close();
-    level = const_cast<const char**>(mapData);
+    navGraph.build(tiles);
+    pathFinder.clear();
+    if (!headless) tileMap.build(tiles, CELL_SIZE);
+}
+
+// Builds an enemy from a level file entry (type letter, grid position); nullptr for unknown types.
+Enemy* Game::createEnemy(char type, float x, float y) {
+    float scale = 2.0f;
+    switch (type) {
+    case 'B':
+        return levelArena.create<BatBrain>(
+            x * CELL_SIZE, y * CELL_SIZE, scale,
+            batBrainIdleLeftTexture, batBrainIdleRightTexture,
+            batBrainMoveLeftTexture, batBrainMoveRightTexture);
+    case 'E':
+        return levelArena.create<BeeBot>(
+            x * CELL_SIZE, y * CELL_SIZE, scale,
+            beeBotIdleLeftTexture, beeBotIdleRightTexture,
+            beeBotMoveLeftTexture, beeBotMoveRightTexture);
+    case 'M':
+        return levelArena.create<Motobug>(
+            x * CELL_SIZE, y * CELL_SIZE, scale,
+            motobugIdleLeftTexture, motobugIdleRightTexture,
+            motobugMoveLeftTexture, motobugMoveRightTexture);
+    case 'C':
+        return levelArena.create<CrabMeat>(
+            x * CELL_SIZE, y * CELL_SIZE, scale,
+            crabMeatIdleLeftTexture, crabMeatIdleRightTexture,
+            crabMeatMoveLeftTexture, crabMeatMoveRightTexture);
+    case 'S':
+        return levelArena.create<EggStinger>(
+            x * CELL_SIZE, y * CELL_SIZE, scale,
+            eggStingerIdleLeftTexture, eggStingerIdleRightTexture,
+            eggStingerMoveLeftTexture, eggStingerMoveRightTexture);
+    default:
+        return nullptr;
+    }
 }
 
 void Game::loadEnemies(const string& filename) {
     ifstream in(filename);
     if (!in.is_open()) {
-        cout << "ENEMY ERROR: Could not open " << filename << "\n";
+        LOG_ERROR("ENEMY ERROR: Could not open %s", filename.c_str());
         return;
     }
 
@@ -896,46 +1411,15 @@ void Game::loadEnemies(const string& filename) {
     while (enemyCount < MAX_ENEMIES && in >> enemyType >> x >> y) {
         in.ignore(numeric_limits<streamsize>::max(), '\n');
 
-        float scale = 2.0f;
-        switch (enemyType) {
-        case 'B':
-            enemies[enemyCount] = new BatBrain(
-                x * CELL_SIZE, y * CELL_SIZE, scale,
-                batBrainIdleLeftTexture, batBrainIdleRightTexture,
-                batBrainMoveLeftTexture, batBrainMoveRightTexture);
-            break;
-        case 'E':
-            enemies[enemyCount] = new BeeBot(
-                x * CELL_SIZE, y * CELL_SIZE, scale,
-                beeBotIdleLeftTexture, beeBotIdleRightTexture,
-                beeBotMoveLeftTexture, beeBotMoveRightTexture);
-            break;
-        case 'M':
-            enemies[enemyCount] = new Motobug(
-                x * CELL_SIZE, y * CELL_SIZE, scale,
-                motobugIdleLeftTexture, motobugIdleRightTexture,
-                motobugMoveLeftTexture, motobugMoveRightTexture);
-            break;
-        case 'C':
-            enemies[enemyCount] = new CrabMeat(
-                x * CELL_SIZE, y * CELL_SIZE, scale,
-                crabMeatIdleLeftTexture, crabMeatIdleRightTexture,
-                crabMeatMoveLeftTexture, crabMeatMoveRightTexture);
-            break;
-        case 'S':
-            enemies[enemyCount] = new EggStinger(
-                x * CELL_SIZE, y * CELL_SIZE, scale,
-                eggStingerIdleLeftTexture, eggStingerIdleRightTexture,
-                eggStingerMoveLeftTexture, eggStingerMoveRightTexture);
-            break;
-        default:
-            continue;
-        }
+        Enemy* enemy = createEnemy(enemyType, x, y);
+        if (!enemy) continue;
+        enemies[enemyCount] = enemy;
         enemyCount++;
     }
 
     in.close();
-    cout << "Loaded " << enemyCount << " enemies.\n";
+    indexEnemies();
+    LOG_INFO("Loaded %d enemies.", enemyCount);
 }
 
 void Game::updateEnemies(float deltaTime, float gravity, float terminalVelocity) {
@@ -945,26 +1429,30 @@ void Game::updateEnemies(float deltaTime, float gravity, float terminalVelocity)
 
     for (int i = 0; i < enemyCount; ++i) {
         if (enemies[i] && enemies[i]->isAlive()) {
-            enemies[i]->update(gravity, terminalVelocity, level, rows, cols, deltaTime,
+            enemies[i]->storePreviousPosition();
+            // Enemies outside the streamed active chunks wait until the player comes back.
+            if (!levelStream.isActive(static_cast<int>(enemies[i]->getPosX()) / CELL_SIZE)) continue;
+            enemies[i]->update(gravity, terminalVelocity, tiles, pathFinder, deltaTime,
                 playerX, playerY, playerInBallForm);
+            if (enemies[i]->isAlive()) enemyGrid.update(i, enemies[i]->getBounds());
+            else enemyGrid.remove(i);
         }
     }
 }
 
-void Game::drawEnemies(RenderWindow& window, const RenderStates& states) {
+void Game::drawEnemies(RenderWindow& window, const RenderStates& states, const FloatRect& visibleArea, float alpha) {
     for (int i = 0; i < enemyCount; ++i) {
         if (enemies[i] && enemies[i]->isAlive()) {
-            enemies[i]->draw(window, states);
+            if (!visibleArea.intersects(enemies[i]->getBounds())) continue;
+            enemies[i]->draw(window, states, alpha);
         }
     }
 }
 
-void Game::checkCollisions() {
-    static float invincibilityTimers[3] = { 0.0f, 0.0f, 0.0f };
-
+void Game::checkCollisions(float deltaTime) {
     for (int i = 0; i < 3; ++i) {
-        if (invincibilityTimers[i] > 0.0f) {
-            invincibilityTimers[i] -= 1.0f / 60.0f;
+        if (hitInvincibilityTimers[i] > 0.0f) {
+            hitInvincibilityTimers[i] -= deltaTime;
         }
     }
 
@@ -976,7 +1464,9 @@ void Game::checkCollisions() {
         bool isMain = (i == mainIndex);
         bool inBallForm = (characters[i]->getCurrentState() == Character::Jumping);
 
-        for (int j = 0; j < enemyCount; ++j) {
+        int nearbyCount = queryNearby(enemyGrid, FloatRect(charX, charY, charWidth, charHeight));
+        for (int n = 0; n < nearbyCount; ++n) {
+            int j = nearby[n];
             if (!enemies[j] || !enemies[j]->isAlive()) continue;
 
             float enemyX = enemies[j]->getPosX();
@@ -993,9 +1483,10 @@ void Game::checkCollisions() {
                 if (inBallForm && isMain) {
                     if (enemies[j]->takeDamage(1, true)) {
                         score += 10; // Add 10 points for damaging enemy
-                        cout << "Enemy damaged! Score: " << score << "\n";
+                        LOG_INFO("Enemy damaged! Score: %d", score);
                         if (!enemies[j]->isAlive()) {
-                            cout << "Enemy defeated!\n";
+                            enemyGrid.remove(j);
+                            LOG_INFO("Enemy defeated!");
                         }
                     }
                     continue;
@@ -1011,14 +1502,14 @@ void Game::checkCollisions() {
                 characters[i]->setVelX(0.0f);
                 characters[i]->setVelY(0.0f);
                 characters[i]->setOnGround(true);
-                cout << (isMain ? "Main character" : "Follower") << " respawned at (" << respawnX << ", " << respawnY << ") due to enemy collision.\n";
+                LOG_INFO("%s respawned at (%.1f, %.1f) due to enemy collision.", isMain ? "Main character" : "Follower", respawnX, respawnY);
 
-                if (isMain && invincibilityTimers[i] <= 0.0f) {
+                if (isMain && hitInvincibilityTimers[i] <= 0.0f) {
                     sharedHP--;
-                    invincibilityTimers[i] = 2.0f;
-                    cout << "Player HP: " << sharedHP << "\n";
+                    hitInvincibilityTimers[i] = 2.0f;
+                    LOG_INFO("Player HP: %d", sharedHP);
                     if (sharedHP <= 0) {
-                        cout << "Game Over!\n";
+                        LOG_INFO("Game Over!");
                     }
                 }
             }
@@ -1026,54 +1517,79 @@ void Game::checkCollisions() {
     }
 }
 
-void Game::drawLevel(RenderWindow& window, Sprite& wallSprite, const RenderStates& states) {
-    for (int y = 0; y < rows; ++y) {
-        for (int x = 0; x < cols; ++x) {
-            char c = level[y][x];
-            if (c == 'w' || c == 'f' || c == 'r') {
-                wallSprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(wallSprite, states);
-            }
-            else if (c == 'b') {
-                blockSprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(blockSprite, states);
-            }
-            else if (c == 'p') {
-                platformSprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(platformSprite, states);
-            }
-            else if (c == 'c') {
-                crystalSprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(crystalSprite, states);
-            }
-            else if (c == 'l') {
-                block3Sprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(block3Sprite, states);
-            }
-            else if (c == 'u') {
-                spikeSprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(spikeSprite, states);
-            }
-            else if (c == 'x') {
-                pitSprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(pitSprite, states);
-            }
-            else if (c == 'g') {
-                grassSprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(grassSprite, states);
-            }
-            else if (c == 'N') {
-                block4Sprite.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-                window.draw(block4Sprite, states);
-            }
-        }
+void Game::drawLevel(RenderWindow& window, const RenderStates& states, const FloatRect& visibleArea) {
+    int firstCol = static_cast<int>(visibleArea.left / CELL_SIZE);
+    int lastCol = static_cast<int>((visibleArea.left + visibleArea.width) / CELL_SIZE);
+    tileMap.draw(window, states, firstCol, lastCol);
+}
+
+// Builds a collectable from a level file entry (type letter, grid position); nullptr for unknown types.
+Collectable* Game::createCollectable(char type, float x, float y) {
+    float width = 32.0f;
+    float height = 32.0f;
+    // The boost kinds are passed as values: create() forwards by reference,
+    // and the class constants have no out-of-class definition to bind to.
+    switch (type) {
+    case 'R':
+        return levelArena.create<Ring>(x * CELL_SIZE, y * CELL_SIZE, width, height, ringTexture);
+    case 'E':
+        return levelArena.create<ExtraLife>(x * CELL_SIZE, y * CELL_SIZE, width, height, extraLifeTexture);
+    case 'S':
+        return levelArena.create<SpecialBoost>(x * CELL_SIZE, y * CELL_SIZE, width, height, speedBoostTexture, static_cast<int>(SpecialBoost::SPEED));
+    case 'J':
+        return levelArena.create<SpecialBoost>(x * CELL_SIZE, y * CELL_SIZE, width, height, jumpBoostTexture, static_cast<int>(SpecialBoost::JUMP));
+    case 'I':
+        return levelArena.create<SpecialBoost>(x * CELL_SIZE, y * CELL_SIZE, width, height, invincibilityBoostTexture, static_cast<int>(SpecialBoost::INVINCIBILITY));
+    default:
+        return nullptr;
     }
 }
 
+// Maps a compiled level blob (see LevelFormat.h) and indexes the tiles
+// straight out of the mapping, unless withTiles is false because they are
+// streamed. The mapping is copy-on-write, so blocks Knuckles breaks only
+// dirty this process's copy of the page; the file and other instances
+// mapping it are untouched.
+bool Game::loadCompiledLevel(const string& filename, bool withTiles) {
+    if (!levelMapping.open(filename)) return false;
+    char* blob = levelMapping.data();
+    const LevelHeader* header = validateLevelBlob(blob, levelMapping.size());
+    if (!header) {
+        LOG_ERROR("LEVEL ERROR: %s is not a valid compiled level", filename.c_str());
+        levelMapping.close();
+        return false;
+    }
+
+    if (withTiles) {
+        tiles.attach(blob + header->tilesOffset, header->rows, header->cols, header->padding);
+        navGraph.build(tiles);
+        pathFinder.clear();
+        if (!headless) tileMap.build(tiles, CELL_SIZE);
+    }
+
+    const LevelEntity* entities = levelEnemies(blob);
+    enemyCount = 0;
+    for (uint32_t i = 0; i < header->enemyCount && enemyCount < MAX_ENEMIES; ++i) {
+        Enemy* enemy = createEnemy(entities[i].type, entities[i].x, entities[i].y);
+        if (enemy) enemies[enemyCount++] = enemy;
+    }
+    entities = levelCollectables(blob);
+    for (uint32_t i = 0; i < header->collectableCount && collectableCount < MAX_COLLECTABLES; ++i) {
+        Collectable* collectable = createCollectable(entities[i].type, entities[i].x, entities[i].y);
+        if (collectable) collectables[collectableCount++] = collectable;
+    }
+    if (!withTiles) levelMapping.close();
+
+    indexEnemies();
+    indexCollectables();
+    LOG_INFO("Loaded compiled level %s: %d enemies, %d collectables.", filename.c_str(), enemyCount, collectableCount);
+    return true;
+}
+
 void Game::loadCollectables(const string& filename) {
     ifstream in(filename);
     if (!in.is_open()) {
-        cout << "COLLECTABLE ERROR: Could not open " << filename << "\n";
+        LOG_ERROR("COLLECTABLE ERROR: Could not open %s", filename.c_str());
         return;
     }
 
@@ -1081,66 +1597,79 @@ void Game::loadCollectables(const string& filename) {
     float x, y;
     while (in >> collectableType >> x >> y && collectableCount < MAX_COLLECTABLES) {
         in.ignore(numeric_limits<streamsize>::max(), '\n');
-        float width = 32.0f;
-        float height = 32.0f;
-        switch (collectableType) {
-        case 'R':
-            collectables[collectableCount] = new Ring(x * CELL_SIZE, y * CELL_SIZE, width, height, ringTexture);
-            collectableCount++;
-            break;
-        case 'E':
-            collectables[collectableCount] = new ExtraLife(x * CELL_SIZE, y * CELL_SIZE, width, height, extraLifeTexture);
-            collectableCount++;
-            break;
-        case 'S':
-            collectables[collectableCount] = new SpecialBoost(x * CELL_SIZE, y * CELL_SIZE, width, height, speedBoostTexture, SpecialBoost::SPEED);
-            collectableCount++;
-            break;
-        case 'J':
-            collectables[collectableCount] = new SpecialBoost(x * CELL_SIZE, y * CELL_SIZE, width, height, jumpBoostTexture, SpecialBoost::JUMP);
-            collectableCount++;
-            break;
-        case 'I':
-            collectables[collectableCount] = new SpecialBoost(x * CELL_SIZE, y * CELL_SIZE, width, height, invincibilityBoostTexture, SpecialBoost::INVINCIBILITY);
-            collectableCount++;
-            break;
-        default:
-            continue;
-        }
+        Collectable* collectable = createCollectable(collectableType, x, y);
+        if (collectable) collectables[collectableCount++] = collectable;
     }
     in.close();
-    cout << "Loaded " << collectableCount << " collectables.\n";
+    indexCollectables();
+    LOG_INFO("Loaded %d collectables.", collectableCount);
 }
 
 void Game::updateCollectables() {
-    for (int i = 0; i < collectableCount; ++i) {
-        if (collectables[i] && collectables[i]->collisionCheck(*characters[mainIndex])) {
+    Character* main = characters[mainIndex];
+    FloatRect area(main->getPosX(), main->getPosY(), main->getWidth(), main->getHeight());
+    int nearbyCount = queryNearby(collectableGrid, area);
+
+    for (int n = 0; n < nearbyCount; ++n) {
+        int i = nearby[n];
+        if (collectables[i] && collectables[i]->collisionCheck(*main)) {
             score += collectables[i]->getScoreValue();
             if (dynamic_cast<Ring*>(collectables[i])) {
-                cout << "Collected a ring! Score: " << score << "\n";
+                LOG_INFO("Collected a ring! Score: %d", score);
             }
             else if (dynamic_cast<ExtraLife*>(collectables[i])) {
                 sharedHP++;
-                cout << "Collected an extra life! Score: " << score << ", HP: " << sharedHP << "\n";
+                LOG_INFO("Collected an extra life! Score: %d, HP: %d", score, sharedHP);
             }
             else if (SpecialBoost* boost = dynamic_cast<SpecialBoost*>(collectables[i])) {
                 applyBoost(characters[mainIndex], boost->getBoostType(), boost->getDuration());
-                cout << "Collected a boost! Score: " << score << "\n";
-            }
-            delete collectables[i];
-            for (int j = i; j < collectableCount - 1; ++j) {
-                collectables[j] = collectables[j + 1];
+                LOG_INFO("Collected a boost! Score: %d", score);
             }
-            collectables[collectableCount - 1] = nullptr;
-            collectableCount--;
-            --i;
+            // Collected items stay in the array (drawing skips them) so grid ids stay valid.
+            collectableGrid.remove(i);
         }
     }
 }
 
-void Game::drawCollectables(RenderWindow& window, const RenderStates& states) {
+void Game::releaseEntities() {
+    levelArena.reset();
+    for (int i = 0; i < enemyCount; ++i) enemies[i] = nullptr;
+    for (int i = 0; i < collectableCount; ++i) collectables[i] = nullptr;
+    enemyCount = 0;
+    collectableCount = 0;
+    enemyGrid.clear();
+    collectableGrid.clear();
+}
+
+// Fills nearby with the candidates grid has for area. Anything past
+// MAX_NEARBY is dropped, which is logged the first time it happens.
+int Game::queryNearby(const SpatialHash& grid, const FloatRect& area) {
+    int total;
+    int count = grid.query(area, nearby, MAX_NEARBY, &total);
+    if (total > count && !nearbyOverflowLogged) {
+        LOG_WARN("SPATIAL HASH: %d entities near (%.0f, %.0f), only %d checked", total, area.left, area.top, count);
+        nearbyOverflowLogged = true;
+    }
+    return count;
+}
+
+void Game::indexEnemies() {
+    enemyGrid.clear();
+    for (int i = 0; i < enemyCount; ++i) {
+        if (enemies[i] && enemies[i]->isAlive()) enemyGrid.insert(i, enemies[i]->getBounds());
+    }
+}
+
+void Game::indexCollectables() {
+    collectableGrid.clear();
+    for (int i = 0; i < collectableCount; ++i) {
+        if (collectables[i] && !collectables[i]->getIsCollected()) collectableGrid.insert(i, collectables[i]->getBounds());
+    }
+}
+
+void Game::drawCollectables(RenderWindow& window, const RenderStates& states, const FloatRect& visibleArea) {
     for (int i = 0; i < collectableCount; ++i) {
-        if (collectables[i]) {
+        if (collectables[i] && visibleArea.intersects(collectables[i]->getBounds())) {
             collectables[i]->draw(window, states);
         }
     }
@@ -1151,15 +1680,15 @@ void Game::applyBoost(Character* character, int type, float duration) {
     case SpecialBoost::SPEED:
         character->currentMaxSpeed = character->getBaseMaxSpeed() * 1.5f;
         speedBoostTimer = duration;
-        cout << "Speed boost applied for " << duration << " seconds.\n";
+        LOG_INFO("Speed boost applied for %.1f seconds.", duration);
         break;
     case SpecialBoost::JUMP:
         jumpBoostTimer = duration;
-        cout << "Jump boost applied for " << duration << " seconds.\n";
+        LOG_INFO("Jump boost applied for %.1f seconds.", duration);
         break;
     case SpecialBoost::INVINCIBILITY:
         invincibilityTimer = duration;
-        cout << "Invincibility boost applied for " << duration << " seconds.\n";
+        LOG_INFO("Invincibility boost applied for %.1f seconds.", duration);
         break;
     }
 }
@@ -1169,21 +1698,21 @@ void Game::updateBoosts(float deltaTime) {
         speedBoostTimer -= deltaTime;
         if (speedBoostTimer <= 0.0f) {
             characters[mainIndex]->currentMaxSpeed = characters[mainIndex]->getBaseMaxSpeed() * 1.2f;
-            cout << "Speed boost expired.\n";
+            LOG_INFO("Speed boost expired.");
         }
     }
 
     if (jumpBoostTimer > 0.0f) {
         jumpBoostTimer -= deltaTime;
         if (jumpBoostTimer <= 0.0f) {
-            cout << "Jump boost expired.\n";
+            LOG_INFO("Jump boost expired.");
         }
     }
 
     if (invincibilityTimer > 0.0f) {
         invincibilityTimer -= deltaTime;
         if (invincibilityTimer <= 0.0f) {
-            cout << "Invincibility boost expired.\n";
+            LOG_INFO("Invincibility boost expired.");
         }
     }
 }
\ No newline at end of file
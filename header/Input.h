@@ -0,0 +1,97 @@
+#pragma once
+#include <SFML/Window.hpp>
+
+// Controls for one frame. Sampled once per frame and handed to every character update.
+struct InputState {
+    bool left;
+    bool right;
+    bool up;
+    bool fly;
+    bool switchCharacter;
+
+    InputState() : left(false), right(false), up(false), fly(false), switchCharacter(false) {}
+
+    // One byte per state, used by the replay log.
+    unsigned char toBits() const {
+        return (left ? 1 : 0) | (right ? 2 : 0) | (up ? 4 : 0) | (fly ? 8 : 0) | (switchCharacter ? 16 : 0);
+    }
+
+    static InputState fromBits(unsigned char bits) {
+        InputState state;
+        state.left = (bits & 1) != 0;
+        state.right = (bits & 2) != 0;
+        state.up = (bits & 4) != 0;
+        state.fly = (bits & 8) != 0;
+        state.switchCharacter = (bits & 16) != 0;
+        return state;
+    }
+};
+
+// Where the per-frame input snapshot comes from. The game polls the live
+// keyboard; headless runs inject a scripted source instead.
+class InputSource {
+public:
+    virtual ~InputSource() {}
+    virtual InputState poll() = 0;
+};
+
+class KeyboardInput : public InputSource {
+public:
+    InputState poll() override {
+        InputState state;
+        state.left = sf::Keyboard::isKeyPressed(sf::Keyboard::Left);
+        state.right = sf::Keyboard::isKeyPressed(sf::Keyboard::Right);
+        state.up = sf::Keyboard::isKeyPressed(sf::Keyboard::Up);
+        state.fly = sf::Keyboard::isKeyPressed(sf::Keyboard::T);
+        return state;
+    }
+};
+
+// Holds keys down over frame ranges, e.g. hold(Right, 0, 600) then hold(Up, 120, 1).
+class ScriptedInput : public InputSource {
+public:
+    static const int MAX_SEGMENTS = 256;
+
+    ScriptedInput() : segmentCount(0), frame(0) {}
+
+    bool hold(sf::Keyboard::Key key, int startFrame, int frameCount) {
+        if (segmentCount >= MAX_SEGMENTS) return false;
+        segments[segmentCount].key = key;
+        segments[segmentCount].start = startFrame;
+        segments[segmentCount].end = startFrame + frameCount;
+        segmentCount++;
+        return true;
+    }
+
+    InputState poll() override {
+        InputState state;
+        state.left = isHeld(sf::Keyboard::Left);
+        state.right = isHeld(sf::Keyboard::Right);
+        state.up = isHeld(sf::Keyboard::Up);
+        state.fly = isHeld(sf::Keyboard::T);
+        state.switchCharacter = isHeld(sf::Keyboard::A);
+        frame++;
+        return state;
+    }
+
+    int getFrame() const { return frame; }
+    void rewind() { frame = 0; }
+
+private:
+    struct Segment {
+        sf::Keyboard::Key key;
+        int start, end;
+    };
+    Segment segments[MAX_SEGMENTS];
+    int segmentCount;
+    int frame;
+
+    bool isHeld(sf::Keyboard::Key key) const {
+        for (int i = 0; i < segmentCount; ++i) {
+            if (segments[i].key == key && frame >= segments[i].start && frame < segments[i].end) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
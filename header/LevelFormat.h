@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Compiled level blob, written by data/level_compiler.cpp from a level's
+// map, enemies and collectables text files. Host byte order, no parsing:
+//   LevelHeader
+//   tile image: (rows + 2 * padding) * stride bytes, already in TileGrid's
+//               padded row-major layout, so it is copied in with one memcpy
+//   enemyCount LevelEntity records, then collectableCount LevelEntity records
+// Each section starts at the offset stored in the header, 4-byte aligned.
+const char LEVEL_MAGIC[4] = { 'S', 'H', 'L', 'V' };
+const uint16_t LEVEL_VERSION = 1;
+
+// Largest level a blob may describe. Keeps every tile index TileGrid computes
+// in int range: (rows + 2 * padding) * stride stays under 2^31.
+const uint32_t LEVEL_MAX_ROWS = 4096;
+const uint32_t LEVEL_MAX_COLS = 65536;
+const uint32_t LEVEL_MAX_PADDING = 16;
+
+struct LevelHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t rows, cols;
+    uint32_t padding, stride;
+    uint32_t tilesOffset;
+    uint32_t enemiesOffset, enemyCount;
+    uint32_t collectablesOffset, collectableCount;
+    uint32_t fileSize;
+};
+
+// Same meaning as a line of the text files: type letter and grid position.
+struct LevelEntity {
+    char type;
+    char reserved[3];
+    float x, y;
+};
+
+static_assert(sizeof(LevelHeader) == 48, "LevelHeader layout changed; bump LEVEL_VERSION");
+static_assert(sizeof(LevelEntity) == 12, "LevelEntity layout changed; bump LEVEL_VERSION");
+
+inline uint64_t levelTileImageSize(const LevelHeader& header) {
+    return (static_cast<uint64_t>(header.rows) + 2 * static_cast<uint64_t>(header.padding)) * header.stride;
+}
+
+// Checks the header and that every section lies inside the blob; returns the
+// header, or nullptr if the blob is not a level this build can read.
+inline const LevelHeader* validateLevelBlob(const char* data, size_t size) {
+    if (size < sizeof(LevelHeader)) return nullptr;
+    const LevelHeader* header = reinterpret_cast<const LevelHeader*>(data);
+    if (memcmp(header->magic, LEVEL_MAGIC, 4) != 0 || header->version != LEVEL_VERSION) return nullptr;
+    if (header->headerSize != sizeof(LevelHeader) || header->fileSize != size) return nullptr;
+    if (header->rows == 0 || header->rows > LEVEL_MAX_ROWS || header->cols == 0 || header->cols > LEVEL_MAX_COLS) return nullptr;
+    if (header->padding > LEVEL_MAX_PADDING) return nullptr;
+    if (static_cast<uint64_t>(header->stride) != static_cast<uint64_t>(header->cols) + 2 * static_cast<uint64_t>(header->padding)) return nullptr;
+
+    uint64_t tilesEnd = static_cast<uint64_t>(header->tilesOffset) + levelTileImageSize(*header);
+    uint64_t enemiesEnd = static_cast<uint64_t>(header->enemiesOffset) + static_cast<uint64_t>(header->enemyCount) * sizeof(LevelEntity);
+    uint64_t collectablesEnd = static_cast<uint64_t>(header->collectablesOffset) + static_cast<uint64_t>(header->collectableCount) * sizeof(LevelEntity);
+    if (tilesEnd > size || enemiesEnd > size || collectablesEnd > size) return nullptr;
+    if (header->enemiesOffset % 4 != 0 || header->collectablesOffset % 4 != 0) return nullptr;
+    return header;
+}
+
+inline const LevelEntity* levelEnemies(const char* data) {
+    return reinterpret_cast<const LevelEntity*>(data + reinterpret_cast<const LevelHeader*>(data)->enemiesOffset);
+}
+
+inline const LevelEntity* levelCollectables(const char* data) {
+    return reinterpret_cast<const LevelEntity*>(data + reinterpret_cast<const LevelHeader*>(data)->collectablesOffset);
+}
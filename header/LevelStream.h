@@ -0,0 +1,346 @@
+#pragma once
+#include "TileGrid.h"
+#include "Logger.h"
+#include <fstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+
+// Chunked level layout (little-endian), written by data/map_chunks.cpp:
+//   "SHCK" | u16 version | u16 rows | u32 cols | u16 chunkWidth
+//   then ceil(cols / chunkWidth) chunks of rows * chunkWidth bytes each.
+// A chunk is a strip of chunkWidth whole columns stored row by row; the last
+// one is padded with ' '. Chunks have a fixed size, so chunk i starts at
+// CHUNK_HEADER_SIZE + i * rows * chunkWidth and needs no index table.
+const char CHUNK_MAGIC[4] = { 'S', 'H', 'C', 'K' };
+const uint16_t CHUNK_VERSION = 1;
+const int CHUNK_HEADER_SIZE = 14;
+
+// Streams a chunked level through a TileGrid window around the camera. A
+// background thread reads chunks from disk; the main thread copies finished
+// ones into the grid in update(), so the simulation never sees a half-written
+// chunk. Memory stays at WINDOW_CHUNKS chunks plus the ones Knuckles edited,
+// and opening a level costs the same however long it is.
+//
+// Chunks within ACTIVE_CHUNKS of the centre are always resident when update()
+// returns (it waits for them if the loader is behind); only they should be
+// simulated, which keeps runs deterministic regardless of disk timing.
+class LevelStream {
+public:
+    static const int WINDOW_CHUNKS = 8;
+    static const int ACTIVE_CHUNKS = 2;
+
+    LevelStream() : rows(0), cols(0), chunkWidth(0), chunkCount(0), chunkSize(0), firstChunk(0),
+        activeFirst(0), activeLast(-1), dirty(nullptr), edited(nullptr), stopping(false), streaming(false) {
+        for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+            installed[i] = false;
+            staging[i].chunk = -1;
+            staging[i].state = Free;
+            staging[i].data = nullptr;
+        }
+    }
+
+    ~LevelStream() {
+        close();
+    }
+
+    // Reads the header, sizes the grid's window and loads the chunks around
+    // column 0. Returns false (leaving the grid alone) if the file is missing or bad.
+    bool open(const std::string& filename, TileGrid& grid) {
+        close();
+        file.open(filename, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        unsigned char header[CHUNK_HEADER_SIZE];
+        if (!file.read(reinterpret_cast<char*>(header), CHUNK_HEADER_SIZE) || memcmp(header, CHUNK_MAGIC, 4) != 0) {
+            LOG_ERROR("%s is not a chunked level", filename.c_str());
+            file.close();
+            return false;
+        }
+        uint16_t version = static_cast<uint16_t>(header[4] | (header[5] << 8));
+        rows = header[6] | (header[7] << 8);
+        cols = header[8] | (header[9] << 8) | (header[10] << 16) | (header[11] << 24);
+        chunkWidth = header[12] | (header[13] << 8);
+        if (version != CHUNK_VERSION || rows <= 0 || cols <= 0 || chunkWidth <= 0) {
+            LOG_ERROR("Unsupported chunked level %s", filename.c_str());
+            file.close();
+            return false;
+        }
+
+        chunkCount = (cols + chunkWidth - 1) / chunkWidth;
+        chunkSize = rows * chunkWidth;
+        path = filename;
+        dirty = new char*[chunkCount];
+        edited = new bool[chunkCount];
+        for (int i = 0; i < chunkCount; ++i) {
+            dirty[i] = nullptr;
+            edited[i] = false;
+        }
+        for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+            installed[i] = false;
+            staging[i].chunk = -1;
+            staging[i].state = Free;
+            staging[i].data = new char[chunkSize];
+        }
+
+        grid.resizeWindow(rows, cols, WINDOW_CHUNKS * chunkWidth);
+        firstChunk = 0;
+        stopping = false;
+        streaming = true;
+        loader = std::thread(&LevelStream::loaderLoop, this);
+        update(grid, 0);
+        LOG_INFO("Streaming %s: %d x %d in %d chunks", filename.c_str(), rows, cols, chunkCount);
+        return true;
+    }
+
+    void close() {
+        if (!streaming) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        requested.notify_all();
+        if (loader.joinable()) loader.join();
+        file.close();
+
+        for (int i = 0; i < chunkCount; ++i) delete[] dirty[i];
+        delete[] dirty;
+        delete[] edited;
+        dirty = nullptr;
+        edited = nullptr;
+        for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+            delete[] staging[i].data;
+            staging[i].data = nullptr;
+        }
+        rows = cols = chunkCount = chunkSize = 0;
+        streaming = false;
+    }
+
+    bool isOpen() const { return streaming; }
+
+    // True if column col is in a chunk that is simulated this frame.
+    bool isActive(int col) const {
+        if (!streaming) return true;
+        int chunk = col / chunkWidth;
+        return col >= 0 && chunk >= activeFirst && chunk <= activeLast;
+    }
+
+    // Records that a resident cell was edited so its chunk survives eviction.
+    void markEdited(int col) {
+        if (streaming && col >= 0 && col < cols) edited[col / chunkWidth] = true;
+    }
+
+    // Moves the window to centre on column centerCol, installs chunks the
+    // loader has finished and queues the missing ones. Blocks only for the
+    // active chunks. Returns true if the grid's contents changed.
+    bool update(TileGrid& grid, int centerCol) {
+        if (!streaming) return false;
+        bool changed = false;
+        int centerChunk = clampChunk(centerCol / chunkWidth);
+        int first = centerChunk - WINDOW_CHUNKS / 2;
+        if (first > chunkCount - WINDOW_CHUNKS) first = chunkCount - WINDOW_CHUNKS;
+        if (first < 0) first = 0;
+
+        if (first != firstChunk) {
+            for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+                int chunk = firstChunk + i;
+                if (installed[i] && (chunk < first || chunk >= first + WINDOW_CHUNKS) && edited[chunk]) {
+                    keepEdits(grid, chunk);
+                }
+            }
+            bool moved[WINDOW_CHUNKS];
+            for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+                int old = first + i - firstChunk;
+                moved[i] = old >= 0 && old < WINDOW_CHUNKS && installed[old];
+            }
+            for (int i = 0; i < WINDOW_CHUNKS; ++i) installed[i] = moved[i];
+            firstChunk = first;
+            grid.setOrigin(firstChunk * chunkWidth);
+            changed = true;
+        }
+
+        activeFirst = clampChunk(centerChunk - ACTIVE_CHUNKS);
+        activeLast = clampChunk(centerChunk + ACTIVE_CHUNKS);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        freeStale();
+        for (int i = 0; i < WINDOW_CHUNKS && firstChunk + i < chunkCount; ++i) {
+            if (installed[i]) continue;
+            int chunk = firstChunk + i;
+            if (dirty[chunk]) {
+                install(grid, chunk, dirty[chunk]);
+                changed = true;
+                continue;
+            }
+            int slot = findStaging(chunk);
+            if (slot >= 0 && staging[slot].state == Loaded) {
+                install(grid, chunk, staging[slot].data);
+                staging[slot].state = Free;
+                changed = true;
+            }
+            else if (slot < 0) {
+                request(chunk);
+            }
+        }
+
+        for (int chunk = activeFirst; chunk <= activeLast; ++chunk) {
+            int i = chunk - firstChunk;
+            if (installed[i]) continue;
+            int slot;
+            while ((slot = findStaging(chunk)) < 0 && (slot = request(chunk)) < 0) {
+                loadedCondition.wait(lock);
+                freeStale();
+            }
+            while (staging[slot].state != Loaded) loadedCondition.wait(lock);
+            install(grid, chunk, staging[slot].data);
+            staging[slot].state = Free;
+            changed = true;
+        }
+        return changed;
+    }
+
+    // Copies chunk into out (rows * chunkWidth bytes) from wherever its
+    // current contents live; used when saving a streamed level.
+    void readChunk(const TileGrid& grid, int chunk, char* out) {
+        if (inWindow(chunk) && installed[chunk - firstChunk]) {
+            copyFromGrid(grid, chunk, out);
+        }
+        else if (dirty[chunk]) {
+            memcpy(out, dirty[chunk], chunkSize);
+        }
+        else {
+            std::ifstream in(path, std::ios::binary);
+            in.seekg(CHUNK_HEADER_SIZE + static_cast<std::streamoff>(chunk) * chunkSize);
+            if (!in.read(out, chunkSize)) memset(out, TileGrid::EMPTY, chunkSize);
+        }
+    }
+
+    int getChunkWidth() const { return chunkWidth; }
+    int getChunkCount() const { return chunkCount; }
+
+private:
+    enum StagingState { Free, Requested, Loaded };
+
+    struct Staging {
+        int chunk;
+        StagingState state;
+        char* data;
+    };
+
+    std::ifstream file; // only read by the loader thread once open() returns
+    std::string path;
+    int rows, cols;
+    int chunkWidth;
+    int chunkCount;
+    int chunkSize;
+    int firstChunk;
+    int activeFirst, activeLast;
+    bool installed[WINDOW_CHUNKS]; // by window position
+    char** dirty;                  // edited chunks that left the window, by chunk index
+    bool* edited;
+    Staging staging[WINDOW_CHUNKS];
+
+    std::thread loader;
+    std::mutex mutex;
+    std::condition_variable requested;
+    std::condition_variable loadedCondition;
+    bool stopping;
+    bool streaming;
+
+    LevelStream(const LevelStream&) = delete;
+    LevelStream& operator=(const LevelStream&) = delete;
+
+    int clampChunk(int chunk) const {
+        if (chunk < 0) return 0;
+        if (chunk >= chunkCount) return chunkCount - 1;
+        return chunk;
+    }
+
+    bool inWindow(int chunk) const {
+        return chunk >= firstChunk && chunk < firstChunk + WINDOW_CHUNKS;
+    }
+
+    // Caller holds the mutex.
+    int findStaging(int chunk) const {
+        for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+            if (staging[i].state != Free && staging[i].chunk == chunk) return i;
+        }
+        return -1;
+    }
+
+    // Caller holds the mutex. Drops finished loads the window has moved past.
+    void freeStale() {
+        for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+            if (staging[i].state == Loaded && !inWindow(staging[i].chunk)) staging[i].state = Free;
+        }
+    }
+
+    // Caller holds the mutex. Returns -1 while every buffer is still busy with
+    // loads queued before the window jumped; those are retried next update.
+    int request(int chunk) {
+        for (int i = 0; i < WINDOW_CHUNKS; ++i) {
+            if (staging[i].state == Free) {
+                staging[i].chunk = chunk;
+                staging[i].state = Requested;
+                requested.notify_one();
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void install(TileGrid& grid, int chunk, const char* data) {
+        int x0 = chunk * chunkWidth;
+        int width = cols - x0 < chunkWidth ? cols - x0 : chunkWidth;
+        for (int y = 0; y < rows; ++y) {
+            memcpy(grid.rowData(y) + x0 - grid.getOriginCol(), data + y * chunkWidth, width);
+        }
+        installed[chunk - firstChunk] = true;
+    }
+
+    void copyFromGrid(const TileGrid& grid, int chunk, char* out) const {
+        int x0 = chunk * chunkWidth;
+        int width = cols - x0 < chunkWidth ? cols - x0 : chunkWidth;
+        for (int y = 0; y < rows; ++y) {
+            memcpy(out + y * chunkWidth, grid.rowData(y) + x0 - grid.getOriginCol(), width);
+            memset(out + y * chunkWidth + width, TileGrid::EMPTY, chunkWidth - width);
+        }
+    }
+
+    void keepEdits(const TileGrid& grid, int chunk) {
+        if (!dirty[chunk]) dirty[chunk] = new char[chunkSize];
+        copyFromGrid(grid, chunk, dirty[chunk]);
+    }
+
+    void loaderLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (stopping) return;
+            int slot = -1;
+            for (int i = 0; i < WINDOW_CHUNKS && slot < 0; ++i) {
+                if (staging[i].state == Requested) slot = i;
+            }
+            if (slot < 0) {
+                requested.wait(lock);
+                continue;
+            }
+
+            // The slot stays Requested while reading, so the main thread leaves it alone.
+            int chunk = staging[slot].chunk;
+            char* data = staging[slot].data;
+            lock.unlock();
+            file.seekg(CHUNK_HEADER_SIZE + static_cast<std::streamoff>(chunk) * chunkSize);
+            if (!file.read(data, chunkSize)) {
+                file.clear();
+                memset(data, TileGrid::EMPTY, chunkSize);
+                LOG_ERROR("Failed to read chunk %d of %s", chunk, path.c_str());
+            }
+            lock.lock();
+            staging[slot].state = Loaded;
+            loadedCondition.notify_all();
+        }
+    }
+};
@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstdarg>
+#include <cstddef>
+
+// Severity levels. Anything below LOG_MIN_LEVEL is compiled out; define
+// LOG_MIN_LEVEL to LOG_LEVEL_OFF before including this header to drop all logging.
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_OFF 4
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Lets GCC and Clang check LOG_* format strings against their arguments.
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT(formatIndex, firstArg) __attribute__((format(printf, formatIndex, firstArg)))
+#else
+#define LOG_PRINTF_FORMAT(formatIndex, firstArg)
+#endif
+
+#define LOG_AT(level, ...) \
+    do { if ((level) >= LOG_MIN_LEVEL) Logger::instance().log((level), __VA_ARGS__); } while (0)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+// Asynchronous logger. Callers format into a slot of a fixed-size lock-free
+// ring and return; a background thread drains the ring to game.log, so the
+// game loop never waits on stdio. When the ring is full the message is dropped
+// and counted rather than blocking the frame. Warnings and errors are echoed
+// to stderr by the writer thread.
+class Logger {
+public:
+    static const int CAPACITY = 1024; // must be a power of two
+    static const int MESSAGE_LENGTH = 120;
+
+    static Logger& instance() {
+        static Logger logger("game.log");
+        return logger;
+    }
+
+    // Argument 1 is the implicit this.
+    LOG_PRINTF_FORMAT(3, 4) void log(int level, const char* format, ...) {
+        // Multi-producer ring: claim a slot by advancing the write index, then
+        // publish it through the slot's sequence number.
+        size_t position = writeIndex.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[position & (CAPACITY - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            long long difference = static_cast<long long>(sequence) - static_cast<long long>(position);
+            if (difference == 0) {
+                if (writeIndex.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            else {
+                position = writeIndex.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        slot->timeMs = elapsedMs();
+        va_list args;
+        va_start(args, format);
+        vsnprintf(slot->text, MESSAGE_LENGTH, format, args);
+        va_end(args);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    unsigned long long getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    ~Logger() {
+        running.store(false, std::memory_order_release);
+        if (writer.joinable()) writer.join();
+        drain();
+        if (dropped.load() > 0) out << "[logger] dropped " << dropped.load() << " messages\n";
+        out.flush();
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        int level;
+        long long timeMs;
+        char text[MESSAGE_LENGTH];
+    };
+
+    Slot slots[CAPACITY];
+    std::atomic<size_t> writeIndex;
+    size_t readIndex; // only touched by the writer thread
+    std::atomic<unsigned long long> dropped;
+    std::atomic<bool> running;
+    std::chrono::steady_clock::time_point start;
+    std::ofstream out;
+    std::thread writer;
+
+    Logger(const char* filename) : writeIndex(0), readIndex(0), dropped(0), running(true) {
+        for (int i = 0; i < CAPACITY; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+        start = std::chrono::steady_clock::now();
+        out.open(filename, std::ios::trunc);
+        if (!out.is_open()) std::cerr << "LOGGER ERROR: Could not open " << filename << "\n";
+        writer = std::thread(&Logger::writerLoop, this);
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    long long elapsedMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static const char* levelName(int level) {
+        switch (level) {
+        case LOG_LEVEL_DEBUG: return "DEBUG";
+        case LOG_LEVEL_INFO: return "INFO";
+        case LOG_LEVEL_WARN: return "WARN";
+        default: return "ERROR";
+        }
+    }
+
+    void writerLoop() {
+        while (running.load(std::memory_order_acquire)) {
+            if (drain() > 0) out.flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    // Writes every published message in order; returns how many were written.
+    int drain() {
+        int written = 0;
+        for (;;) {
+            Slot& slot = slots[readIndex & (CAPACITY - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != readIndex + 1) break;
+
+            out << "[" << slot.timeMs << "ms] " << levelName(slot.level) << ": " << slot.text << "\n";
+            if (slot.level >= LOG_LEVEL_WARN) std::cerr << levelName(slot.level) << ": " << slot.text << "\n";
+
+            slot.sequence.store(readIndex + CAPACITY, std::memory_order_release);
+            readIndex++;
+            written++;
+        }
+        return written;
+    }
+};
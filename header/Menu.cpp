@@ -1,22 +1,20 @@
 #include "Menu.h"
 
-Menu::Menu(Font& fontRef, Music& music)
+Menu::Menu(AssetCache& assets, Font& fontRef, Music& music)
     : font(fontRef), music(music), selectedIndex(0), isLevelSubmenu(false),
     isSaveSlotSubmenu(false), isScoreboardView(false), musicOn(true), selectedLevel(1), backgroundX(0.0f),
     fadeDuration(2.0f), entryCount(0) {
     // Load background
-    if (!backgroundTexture.loadFromFile("Data/image_fx.jpg"))
-        cout << "Error loading background image\n";
-    backgroundSprite.setTexture(backgroundTexture);
+    backgroundTexture = assets.texture("Data/image_fx.jpg");
+    backgroundSprite.setTexture(*backgroundTexture);
     backgroundSprite.setScale(1.5f, 1.5f);
 
     // Load logo
-    if (!logoTexture.loadFromFile("Data/logo.png"))
-        cout << "Error loading logo image\n";
+    logoTexture = assets.texture("Data/logo.png");
     float logoScale = 0.6f;
-    logoSprite.setTexture(logoTexture);
+    logoSprite.setTexture(*logoTexture);
     logoSprite.setScale(logoScale, logoScale);
-    logoSprite.setPosition((1200 - logoTexture.getSize().x * logoScale) / 2, 20);
+    logoSprite.setPosition((1200 - logoTexture->getSize().x * logoScale) / 2, 20);
 
     // Shadow
     shadowSprite = logoSprite;
@@ -121,7 +119,7 @@ int Menu::run(RenderWindow& window) {
 
         // Animate background
         backgroundX += 0.5f;
-        if (backgroundX >= backgroundTexture.getSize().x) backgroundX = 0;
+        if (backgroundX >= backgroundTexture->getSize().x) backgroundX = 0;
         backgroundSprite.setPosition(-backgroundX, 0);
 
         // Fade logo
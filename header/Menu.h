@@ -1,6 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include "AssetCache.h"
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -11,7 +12,7 @@ public:
     static const int LOAD_GAME = 1;
     static const int EXIT = 2;
 
-    Menu(sf::Font& fontRef, sf::Music& music);
+    Menu(AssetCache& assets, sf::Font& fontRef, sf::Music& music);
     int run(sf::RenderWindow& window);
     int getSelectedLevel() const;
     std::string getSelectedSaveSlot() const;
@@ -20,7 +21,7 @@ public:
 private:
     sf::Font& font;
     sf::Music& music;
-    sf::Texture backgroundTexture, logoTexture;
+    TextureHandle backgroundTexture, logoTexture;
     sf::Sprite backgroundSprite, logoSprite, shadowSprite;
     sf::Text mainMenuItems[6];
     sf::Text levelMenuItems[4];
@@ -0,0 +1,158 @@
+#pragma once
+#include "TileGrid.h"
+#include "TileProperties.h"
+
+// What followers need to know about the tiles ahead of them, worked out once
+// per level instead of probed cell by cell every frame:
+//  - walls: for each column, running counts of side-solid cells down its rows,
+//    so "is there a wall in rows top..bot" is a single subtraction;
+//  - walkable cells: floor a jump can land on, and the '.' cells that mark a drop;
+//  - gaps: for each cell, how many empty cells run from it to the left and to
+//    the right (up to MAX_GAP), the width a follower has to jump to cross.
+//
+// Only the grid's resident window is covered; other columns of the level read
+// as empty, like TileGrid::get(). build() again after a map is loaded or the
+// streamed window moved, and patchCell() after a single tile changes.
+class NavGraph {
+public:
+    static const int MAX_GAP = 6;
+    static const int SOLID_WALLS = 0;       // every TILE_SOLID_SIDE tile
+    static const int UNBREAKABLE_WALLS = 1; // the same, minus the ones Knuckles punches through
+    static const int WALL_KINDS = 2;
+
+    NavGraph() : cells(nullptr), walls(nullptr), rows(0), cols(0), originCol(0), windowCols(0) {}
+
+    ~NavGraph() {
+        release();
+    }
+
+    void build(const TileGrid& level) {
+        release();
+        if (level.isEmpty()) {
+            rows = cols = originCol = windowCols = 0;
+            return;
+        }
+        rows = level.getRows();
+        cols = level.getCols();
+        originCol = level.getOriginCol();
+        windowCols = level.getWindowCols();
+        cells = new Cell[rows * windowCols];
+        walls = new short[WALL_KINDS * windowCols * (rows + 1)];
+        for (int x = originCol; x < originCol + windowCols; ++x) buildColumn(level, x);
+        for (int y = 0; y < rows; ++y) buildGaps(y, originCol, originCol + windowCols - 1);
+    }
+
+    // Cell (x, y) of the grid changed; only its column and the gap runs of its
+    // row within reach of it need redoing.
+    void patchCell(const TileGrid& level, int x, int y) {
+        if (!contains(x, y)) return;
+        buildColumn(level, x);
+        buildGaps(y, x - MAX_GAP, x + MAX_GAP);
+    }
+
+    int getCols() const { return cols; }
+
+    // Whether rows top..bot of column x hold a wall of the given kind.
+    bool hasWall(int x, int top, int bot, int kind) const {
+        if (x < originCol || x >= originCol + windowCols) return false;
+        if (top < 0) top = 0;
+        if (bot >= rows) bot = rows - 1;
+        if (top > bot) return false;
+        const short* counts = wallCounts(kind, x);
+        return counts[bot + 1] - counts[top] > 0;
+    }
+
+    bool isFloor(int x, int y) const {
+        return contains(x, y) && (cell(x, y).flags & FLOOR) != 0;
+    }
+
+    bool isDrop(int x, int y) const {
+        return contains(x, y) && (cell(x, y).flags & DROP) != 0;
+    }
+
+    // Empty cells in row y from column x onwards in direction (+1 or -1),
+    // stopping at the map edge and at MAX_GAP.
+    int gapWidth(int x, int y, int direction) const {
+        if (y < 0 || y >= rows) return 0;
+        if (x < originCol || x >= originCol + windowCols) return gapOutside(x, y, direction);
+        return direction > 0 ? cell(x, y).gapRight : cell(x, y).gapLeft;
+    }
+
+private:
+    static const unsigned char FLOOR = 1 << 0;
+    static const unsigned char DROP = 1 << 1;
+    static const unsigned char EMPTY = 1 << 2;
+
+    struct Cell {
+        unsigned char flags;
+        unsigned char gapLeft;
+        unsigned char gapRight;
+    };
+
+    Cell* cells;
+    short* walls; // per kind and column, rows + 1 running counts
+    int rows, cols;
+    int originCol, windowCols;
+
+    NavGraph(const NavGraph&) = delete;
+    NavGraph& operator=(const NavGraph&) = delete;
+
+    void release() {
+        delete[] cells;
+        delete[] walls;
+        cells = nullptr;
+        walls = nullptr;
+    }
+
+    bool contains(int x, int y) const {
+        return x >= originCol && x < originCol + windowCols && y >= 0 && y < rows;
+    }
+
+    Cell& cell(int x, int y) { return cells[y * windowCols + x - originCol]; }
+    const Cell& cell(int x, int y) const { return cells[y * windowCols + x - originCol]; }
+    short* wallCounts(int kind, int x) { return walls + (kind * windowCols + x - originCol) * (rows + 1); }
+    const short* wallCounts(int kind, int x) const { return walls + (kind * windowCols + x - originCol) * (rows + 1); }
+
+    void buildColumn(const TileGrid& level, int x) {
+        short* solid = wallCounts(SOLID_WALLS, x);
+        short* unbreakable = wallCounts(UNBREAKABLE_WALLS, x);
+        solid[0] = unbreakable[0] = 0;
+        for (int y = 0; y < rows; ++y) {
+            char c = level.at(x, y);
+            bool wall = tileHas(c, TILE_SOLID_SIDE);
+            solid[y + 1] = solid[y] + (wall ? 1 : 0);
+            unbreakable[y + 1] = unbreakable[y] + (wall && !tileHas(c, TILE_BREAKABLE) ? 1 : 0);
+
+            unsigned char flags = 0;
+            if (tileHas(c, TILE_FLOOR)) flags |= FLOOR;
+            if (c == '.') flags |= DROP;
+            if (c == TileGrid::EMPTY) flags |= EMPTY;
+            cell(x, y).flags = flags;
+        }
+    }
+
+    // Columns of the level outside the window are empty: a run starting out
+    // there goes on to the map edge, or into the window and on from there.
+    int gapOutside(int x, int y, int direction) const {
+        if (x < 0 || x >= cols) return 0;
+        int run;
+        if (direction > 0) run = x < originCol ? originCol - x + cell(originCol, y).gapRight : cols - x;
+        else run = x >= originCol + windowCols ? x - (originCol + windowCols) + 1 + cell(originCol + windowCols - 1, y).gapLeft : x + 1;
+        return run < MAX_GAP ? run : MAX_GAP;
+    }
+
+    // Recomputes the gap runs of row y for columns first..last, which must
+    // cover every column whose run could have changed.
+    void buildGaps(int y, int first, int last) {
+        if (first < originCol) first = originCol;
+        if (last > originCol + windowCols - 1) last = originCol + windowCols - 1;
+        for (int x = last; x >= first; --x) {
+            int next = x + 1 < originCol + windowCols ? cell(x + 1, y).gapRight : gapOutside(x + 1, y, 1);
+            cell(x, y).gapRight = (cell(x, y).flags & EMPTY) ? static_cast<unsigned char>(next < MAX_GAP ? next + 1 : MAX_GAP) : 0;
+        }
+        for (int x = first; x <= last; ++x) {
+            int next = x - 1 >= originCol ? cell(x - 1, y).gapLeft : gapOutside(x - 1, y, -1);
+            cell(x, y).gapLeft = (cell(x, y).flags & EMPTY) ? static_cast<unsigned char>(next < MAX_GAP ? next + 1 : MAX_GAP) : 0;
+        }
+    }
+};
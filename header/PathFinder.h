@@ -0,0 +1,394 @@
+#pragma once
+#include "TileGrid.h"
+#include "TileProperties.h"
+#include <cstdlib>
+
+// A* over the tile grid for anything that chases something: followers after
+// the leader, enemies after the player. Cells are the nodes.
+//
+// Movers are bodyRows cells tall; a cell is open to one when that many cells,
+// counting up from it, are free of anything solid or harmful.
+// A WALKER stands in an open cell with floor under it and moves by walking to
+// the next column, stepping off a ledge and falling to the floor below, or
+// jumping: up to jumpRows rows straight up (as far as the cells above are
+// open), across up to JUMP_COLS columns, then down to the first floor. A
+// FLYER moves to any open neighbouring cell.
+//
+// Callers ask for the next step with nextStep(). Answers come from a small
+// cache of finished paths; a query that misses is queued and searched by
+// update(), which runs once a frame and stops after a fixed number of node
+// expansions, carrying on the next frame. Counting expansions rather than
+// time keeps the results, and so replays, deterministic.
+class PathFinder {
+public:
+    static const int WALKER = 0;
+    static const int FLYER = 1;
+
+    static const int FOUND = 0;   // step holds the next cell
+    static const int PENDING = 1; // no answer yet; ask again next frame
+    static const int NO_PATH = 2; // the goal cannot be reached
+
+    static const int JUMP_COLS = 5; // a running jump clears about four cells, edge to edge
+    static const int MAX_PATH = 64;            // cells kept of each path, nearest the start
+    static const int MAX_CACHED = 16;
+    static const int MAX_PENDING = 16;
+    static const int MAX_EXPANSIONS = 4096;    // per search, so a hopeless one gives up
+    static const int EXPANSIONS_PER_FRAME = 1024;
+    static const int HEAP_SIZE = MAX_EXPANSIONS * 16; // pushes past this are dropped
+
+    struct Step {
+        int x, y;
+        bool jump; // reaching the cell needs a jump from the one before
+    };
+
+    PathFinder() : gScore(nullptr), parent(nullptr), jumpedTo(nullptr), seen(nullptr), closed(nullptr),
+        heap(nullptr), heapCount(0), nodeCount(0), searchId(0), expansions(0), searching(false),
+        pendingCount(0), frame(0), rows(0), windowCols(0), originCol(0)
+    {
+        for (int i = 0; i < MAX_CACHED; ++i) cache[i].used = false;
+        heap = new HeapEntry[HEAP_SIZE];
+    }
+
+    ~PathFinder() {
+        releaseNodes();
+        delete[] heap;
+    }
+
+    // Forgets every path and search; call whenever the tiles change.
+    void clear() {
+        for (int i = 0; i < MAX_CACHED; ++i) cache[i].used = false;
+        pendingCount = 0;
+        searching = false;
+    }
+
+    // Next cell on the way from cell (fromX, fromY) to cell (toX, toY), or the
+    // goal itself once there. Either end may be in the air; a WALKER's is
+    // moved down to the floor below it.
+    int nextStep(const TileGrid& level, int mode, int bodyRows, int jumpRows, int fromX, int fromY, int toX, int toY, Step& step) {
+        if (!settle(level, mode, bodyRows, fromX, fromY) || !settle(level, mode, bodyRows, toX, toY)) return NO_PATH;
+        if (fromX == toX && fromY == toY) {
+            step.x = toX;
+            step.y = toY;
+            step.jump = false;
+            return FOUND;
+        }
+
+        for (int i = 0; i < MAX_CACHED; ++i) {
+            Path& path = cache[i];
+            if (!path.used || path.mode != mode || path.bodyRows != bodyRows || path.jumpRows != jumpRows) continue;
+            if (!path.found) {
+                if (path.startX == fromX && path.startY == fromY && path.goalX == toX && path.goalY == toY) {
+                    path.lastUsed = frame;
+                    return NO_PATH;
+                }
+                continue;
+            }
+            // A path to a goal a cell away still leads the right way.
+            if (abs(path.goalX - toX) > 1 || abs(path.goalY - toY) > 1) continue;
+            for (int j = 0; j + 1 < path.length; ++j) {
+                if (path.cells[j].x == fromX && path.cells[j].y == fromY) {
+                    path.lastUsed = frame;
+                    step = path.cells[j + 1];
+                    return FOUND;
+                }
+            }
+        }
+
+        queue(mode, bodyRows, jumpRows, fromX, fromY, toX, toY);
+        return PENDING;
+    }
+
+    // Works through queued searches until the frame's expansions are used up.
+    void update(const TileGrid& level) {
+        frame++;
+        if (level.isEmpty()) return;
+        if (level.getRows() * level.getWindowCols() != nodeCount) allocateNodes(level.getRows() * level.getWindowCols());
+        rows = level.getRows();
+        windowCols = level.getWindowCols();
+        originCol = level.getOriginCol();
+
+        int budget = EXPANSIONS_PER_FRAME;
+        while (budget > 0) {
+            if (!searching) {
+                if (pendingCount == 0) return;
+                current = pending[0];
+                for (int i = 1; i < pendingCount; ++i) pending[i - 1] = pending[i];
+                pendingCount--;
+                beginSearch();
+            }
+            budget -= search(level, budget);
+        }
+    }
+
+    int getPendingCount() const { return pendingCount + (searching ? 1 : 0); }
+
+private:
+    struct Request {
+        int mode, bodyRows, jumpRows;
+        int startX, startY, goalX, goalY;
+    };
+
+    struct Path {
+        bool used, found;
+        int mode, bodyRows, jumpRows;
+        int startX, startY, goalX, goalY;
+        Step cells[MAX_PATH];
+        int length;
+        long long lastUsed;
+    };
+
+    struct HeapEntry {
+        int f, node;
+    };
+
+    Path cache[MAX_CACHED];
+    Request pending[MAX_PENDING];
+    Request current;
+
+    // Per-cell search state; seen and closed hold the id of the search that
+    // last touched the cell, so nothing needs clearing between searches.
+    int* gScore;
+    int* parent;
+    bool* jumpedTo;
+    int* seen;
+    int* closed;
+    HeapEntry* heap;
+    int heapCount;
+    int nodeCount;
+    int searchId;
+    int expansions;
+    bool searching;
+    int pendingCount;
+    long long frame;
+    int rows, windowCols, originCol;
+
+    PathFinder(const PathFinder&) = delete;
+    PathFinder& operator=(const PathFinder&) = delete;
+
+    void allocateNodes(int count) {
+        releaseNodes();
+        nodeCount = count;
+        gScore = new int[count];
+        parent = new int[count];
+        jumpedTo = new bool[count];
+        seen = new int[count];
+        closed = new int[count];
+        for (int i = 0; i < count; ++i) seen[i] = closed[i] = 0;
+        searchId = 0;
+        searching = false;
+    }
+
+    void releaseNodes() {
+        delete[] gScore;
+        delete[] parent;
+        delete[] jumpedTo;
+        delete[] seen;
+        delete[] closed;
+        gScore = parent = seen = closed = nullptr;
+        jumpedTo = nullptr;
+        nodeCount = 0;
+    }
+
+    // Rows above the top of the map count as open, so a body may stick out there.
+    static bool isOpen(const TileGrid& level, int bodyRows, int x, int y) {
+        if (!level.contains(x, y)) return false;
+        for (int row = y; row > y - bodyRows && row >= 0; --row) {
+            if (tileFlags(level.at(x, row)) & (TILE_SOLID | TILE_HAZARD | TILE_PIT)) return false;
+        }
+        return true;
+    }
+
+    static bool canStand(const TileGrid& level, int bodyRows, int x, int y) {
+        return isOpen(level, bodyRows, x, y) && y + 1 < level.getRows() && tileHas(level.at(x, y + 1), TILE_FLOOR);
+    }
+
+    // Moves a WALKER's cell down onto the floor; false if there is none.
+    static bool settle(const TileGrid& level, int mode, int bodyRows, int x, int& y) {
+        if (y < 0) y = 0;
+        if (!isOpen(level, bodyRows, x, y)) return false;
+        if (mode == FLYER) return true;
+        while (isOpen(level, bodyRows, x, y) && !canStand(level, bodyRows, x, y)) y++;
+        return canStand(level, bodyRows, x, y);
+    }
+
+    void queue(int mode, int bodyRows, int jumpRows, int fromX, int fromY, int toX, int toY) {
+        Request request = { mode, bodyRows, jumpRows, fromX, fromY, toX, toY };
+        if (searching && sameRequest(current, request)) return;
+        for (int i = 0; i < pendingCount; ++i) {
+            if (sameRequest(pending[i], request)) return;
+        }
+        // Callers that moved on have stopped asking the oldest questions.
+        if (pendingCount == MAX_PENDING) {
+            for (int i = 1; i < pendingCount; ++i) pending[i - 1] = pending[i];
+            pendingCount--;
+        }
+        pending[pendingCount++] = request;
+    }
+
+    static bool sameRequest(const Request& a, const Request& b) {
+        return a.mode == b.mode && a.bodyRows == b.bodyRows && a.jumpRows == b.jumpRows && a.startX == b.startX && a.startY == b.startY &&
+            a.goalX == b.goalX && a.goalY == b.goalY;
+    }
+
+    int node(int x, int y) const { return y * windowCols + x - originCol; }
+
+    int heuristic(int x, int y) const {
+        return abs(x - current.goalX) + abs(y - current.goalY);
+    }
+
+    void beginSearch() {
+        searchId++;
+        heapCount = 0;
+        expansions = 0;
+        searching = true;
+        int start = node(current.startX, current.startY);
+        seen[start] = searchId;
+        gScore[start] = 0;
+        parent[start] = -1;
+        jumpedTo[start] = false;
+        push(heuristic(current.startX, current.startY), start);
+    }
+
+    // Expands up to budget nodes of the current search; returns how many it did.
+    int search(const TileGrid& level, int budget) {
+        int done = 0;
+        while (done < budget) {
+            if (heapCount == 0 || expansions >= MAX_EXPANSIONS) {
+                finish(-1);
+                return done + 1;
+            }
+            HeapEntry top = pop();
+            if (closed[top.node] == searchId) continue;
+            closed[top.node] = searchId;
+            done++;
+            expansions++;
+
+            int x = top.node % windowCols + originCol;
+            int y = top.node / windowCols;
+            if (x == current.goalX && y == current.goalY) {
+                finish(top.node);
+                return done;
+            }
+            if (current.mode == FLYER) expandFlyer(level, x, y);
+            else expandWalker(level, x, y);
+        }
+        return done;
+    }
+
+    void expandFlyer(const TileGrid& level, int x, int y) {
+        static const int dx[4] = { 1, -1, 0, 0 };
+        static const int dy[4] = { 0, 0, 1, -1 };
+        for (int i = 0; i < 4; ++i) {
+            if (isOpen(level, current.bodyRows, x + dx[i], y + dy[i])) relax(x, y, x + dx[i], y + dy[i], 1, false);
+        }
+    }
+
+    void expandWalker(const TileGrid& level, int x, int y) {
+        for (int dir = -1; dir <= 1; dir += 2) {
+            // Walk on, or step off the ledge and fall to the floor below.
+            int nx = x + dir;
+            int ny = y;
+            if (settle(level, WALKER, current.bodyRows, nx, ny)) relax(x, y, nx, ny, 1 + (ny - y), false);
+
+            // Jump: rise to some height the jump and the cells above allow,
+            // go across at that height, then down onto the first floor in
+            // each column in reach. Low arcs get under overhangs high ones hit.
+            if (current.jumpRows == 0) continue;
+            int top = y;
+            while (y - top < current.jumpRows && isOpen(level, current.bodyRows, x, top - 1)) top--;
+            for (int peak = y; peak >= top; --peak) {
+                for (int cols = 1; cols <= JUMP_COLS; ++cols) {
+                    int jx = x + cols * dir;
+                    if (!isOpen(level, current.bodyRows, jx, peak)) break;
+                    int jy = peak;
+                    if (!settle(level, WALKER, current.bodyRows, jx, jy)) continue;
+                    if (cols == 1 && jy == ny) continue; // a plain walk gets there
+                    relax(x, y, jx, jy, 2 + cols + (y - peak) + abs(jy - y), true);
+                }
+            }
+        }
+    }
+
+    void relax(int x, int y, int nx, int ny, int cost, bool jump) {
+        int from = node(x, y);
+        int to = node(nx, ny);
+        if (closed[to] == searchId) return;
+        int g = gScore[from] + cost;
+        if (seen[to] == searchId && g >= gScore[to]) return;
+        seen[to] = searchId;
+        gScore[to] = g;
+        parent[to] = from;
+        jumpedTo[to] = jump;
+        push(g + heuristic(nx, ny), to);
+    }
+
+    // Stores the finished search in the least recently used cache slot; goal
+    // is -1 if the search found nothing.
+    void finish(int goal) {
+        searching = false;
+        int slot = 0;
+        for (int i = 0; i < MAX_CACHED; ++i) {
+            if (!cache[i].used) {
+                slot = i;
+                break;
+            }
+            if (cache[i].lastUsed < cache[slot].lastUsed) slot = i;
+        }
+        Path& path = cache[slot];
+        path.used = true;
+        path.found = goal >= 0;
+        path.mode = current.mode;
+        path.bodyRows = current.bodyRows;
+        path.jumpRows = current.jumpRows;
+        path.startX = current.startX;
+        path.startY = current.startY;
+        path.goalX = current.goalX;
+        path.goalY = current.goalY;
+        path.length = 0;
+        path.lastUsed = frame;
+        if (goal < 0) return;
+
+        // Long paths keep only the cells nearest the start; the path is
+        // searched again once the caller has walked off the end of them.
+        int length = 0;
+        for (int n = goal; n >= 0; n = parent[n]) length++;
+        int skip = length > MAX_PATH ? length - MAX_PATH : 0;
+        int n = goal;
+        for (int i = 0; i < skip; ++i) n = parent[n];
+        path.length = length - skip;
+        for (int i = path.length - 1; i >= 0; --i, n = parent[n]) {
+            path.cells[i].x = n % windowCols + originCol;
+            path.cells[i].y = n / windowCols;
+            path.cells[i].jump = jumpedTo[n];
+        }
+    }
+
+    void push(int f, int node) {
+        if (heapCount >= HEAP_SIZE) return;
+        int i = heapCount++;
+        while (i > 0) {
+            int up = (i - 1) / 2;
+            if (heap[up].f <= f) break;
+            heap[i] = heap[up];
+            i = up;
+        }
+        heap[i].f = f;
+        heap[i].node = node;
+    }
+
+    HeapEntry pop() {
+        HeapEntry top = heap[0];
+        HeapEntry last = heap[--heapCount];
+        int i = 0;
+        while (true) {
+            int child = 2 * i + 1;
+            if (child >= heapCount) break;
+            if (child + 1 < heapCount && heap[child + 1].f < heap[child].f) child++;
+            if (last.f <= heap[child].f) break;
+            heap[i] = heap[child];
+            i = child;
+        }
+        if (heapCount > 0) heap[i] = last;
+        return top;
+    }
+};
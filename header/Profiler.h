@@ -0,0 +1,179 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+
+// Per-phase frame timings. ScopedTimer adds the time spent in a phase to the
+// current frame; endFrame() closes the frame and pushes every phase into a
+// rolling history used by the F3 overlay. The most recent timer spans are also
+// kept so they can be written out as a Chrome trace (chrome://tracing, Perfetto).
+// A disabled profiler records nothing and its ScopedTimers skip the clock, so
+// headless runs, replays and benchmarks don't pay for it.
+class Profiler {
+public:
+    static const int Input = 0;
+    static const int Simulation = 1;
+    static const int MainUpdate = 2;
+    static const int Followers = 3;
+    static const int Enemies = 4;
+    static const int Collisions = 5;
+    static const int Hazards = 6;
+    static const int Collectables = 7;
+    static const int DrawLevel = 8;
+    static const int DrawCharacters = 9;
+    static const int DrawEnemies = 10;
+    static const int DrawCollectables = 11;
+    static const int DrawHud = 12;
+    static const int Display = 13;
+    static const int PhaseCount = 14;
+
+    static const int HISTORY_FRAMES = 120;
+    static const int MAX_TRACE_EVENTS = 1 << 16;
+
+    Profiler() : frameIndex(0), historyCount(0), traceStart(0), traceCount(0), overlayVisible(false), enabled(true) {
+        origin = std::chrono::steady_clock::now();
+        for (int i = 0; i < PhaseCount; ++i) {
+            current[i] = 0.0f;
+            for (int j = 0; j < HISTORY_FRAMES; ++j) history[i][j] = 0.0f;
+        }
+        traceEvents = new TraceEvent[MAX_TRACE_EVENTS];
+    }
+
+    ~Profiler() {
+        delete[] traceEvents;
+    }
+
+    static const char* phaseName(int phase) {
+        static const char* const names[PhaseCount] = {
+            "input", "simulation", "main update", "followers", "enemies", "collisions", "hazards",
+            "collectables", "draw level", "draw characters", "draw enemies", "draw collectables",
+            "draw hud", "display"
+        };
+        return names[phase];
+    }
+
+    // Microseconds since the profiler was created.
+    long long now() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - origin).count();
+    }
+
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+
+    void addSpan(int phase, long long startUs, long long endUs) {
+        if (!enabled) return;
+        current[phase] += (endUs - startUs) / 1000.0f;
+
+        // Oldest spans are overwritten so the trace always holds the last few seconds.
+        TraceEvent& event = traceEvents[(traceStart + traceCount) % MAX_TRACE_EVENTS];
+        event.phase = phase;
+        event.start = startUs;
+        event.duration = endUs - startUs;
+        if (traceCount < MAX_TRACE_EVENTS) traceCount++;
+        else traceStart = (traceStart + 1) % MAX_TRACE_EVENTS;
+    }
+
+    void endFrame() {
+        for (int i = 0; i < PhaseCount; ++i) {
+            history[i][frameIndex] = current[i];
+            current[i] = 0.0f;
+        }
+        frameIndex = (frameIndex + 1) % HISTORY_FRAMES;
+        if (historyCount < HISTORY_FRAMES) historyCount++;
+    }
+
+    void toggleOverlay() { overlayVisible = !overlayVisible; }
+    bool isOverlayVisible() const { return overlayVisible; }
+    bool hasTrace() const { return traceCount > 0; }
+
+    // Rolling min / avg / p99 in milliseconds over the last HISTORY_FRAMES frames.
+    void getStats(int phase, float& minMs, float& avgMs, float& p99Ms) const {
+        minMs = avgMs = p99Ms = 0.0f;
+        if (historyCount == 0) return;
+
+        float sorted[HISTORY_FRAMES];
+        float sum = 0.0f;
+        for (int i = 0; i < historyCount; ++i) {
+            sorted[i] = history[phase][i];
+            sum += sorted[i];
+        }
+        std::sort(sorted, sorted + historyCount);
+        minMs = sorted[0];
+        avgMs = sum / historyCount;
+        p99Ms = sorted[(historyCount * 99) / 100];
+    }
+
+    void drawOverlay(sf::RenderWindow& window, const sf::Font& font) const {
+        if (!overlayVisible) return;
+
+        std::string textString = "phase               min    avg    p99 (ms)\n";
+        char line[64];
+        for (int i = 0; i < PhaseCount; ++i) {
+            float minMs, avgMs, p99Ms;
+            getStats(i, minMs, avgMs, p99Ms);
+            snprintf(line, sizeof(line), "%-18s %6.2f %6.2f %6.2f\n", phaseName(i), minMs, avgMs, p99Ms);
+            textString += line;
+        }
+
+        sf::Text text(textString, font, 14);
+        text.setFillColor(sf::Color::White);
+        text.setPosition(window.getSize().x - 380.0f, 10.0f);
+
+        sf::FloatRect bounds = text.getGlobalBounds();
+        sf::RectangleShape background(sf::Vector2f(bounds.width + 16.0f, bounds.height + 16.0f));
+        background.setPosition(bounds.left - 8.0f, bounds.top - 8.0f);
+        background.setFillColor(sf::Color(0, 0, 0, 170));
+
+        window.draw(background);
+        window.draw(text);
+    }
+
+    bool writeTrace(const std::string& filename) const {
+        std::ofstream out(filename);
+        if (!out.is_open()) return false;
+
+        out << "{\"traceEvents\":[\n";
+        for (int i = 0; i < traceCount; ++i) {
+            const TraceEvent& event = traceEvents[(traceStart + i) % MAX_TRACE_EVENTS];
+            out << "{\"name\":\"" << phaseName(event.phase) << "\",\"ph\":\"X\",\"ts\":" << event.start
+                << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":1}";
+            out << (i + 1 < traceCount ? ",\n" : "\n");
+        }
+        out << "]}\n";
+        return true;
+    }
+
+private:
+    struct TraceEvent {
+        int phase;
+        long long start;
+        long long duration;
+    };
+
+    std::chrono::steady_clock::time_point origin;
+    float current[PhaseCount];
+    float history[PhaseCount][HISTORY_FRAMES];
+    int frameIndex;
+    int historyCount;
+    TraceEvent* traceEvents;
+    int traceStart;
+    int traceCount;
+    bool overlayVisible;
+    bool enabled;
+};
+
+// Times the enclosing scope as one span of the given phase.
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler& profiler, int phase) : profiler(profiler), phase(phase), start(profiler.isEnabled() ? profiler.now() : 0) {}
+    ~ScopedTimer() { if (profiler.isEnabled()) profiler.addSpan(phase, start, profiler.now()); }
+
+private:
+    Profiler& profiler;
+    int phase;
+    long long start;
+};
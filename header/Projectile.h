@@ -2,6 +2,9 @@
 #include <SFML/Graphics.hpp>
 #include <cmath>
 #include <iostream>
+#include "TileProperties.h"
+#include "TileGrid.h"
+#include "TileSweep.h"
 
 using namespace sf;
 
@@ -30,17 +33,19 @@ public:
         sprite.setScale(0.5f, 0.5f); // Small projectile size
     }
 
-    void update(float deltaTime, const char** level, int rows, int cols, float playerX, float playerY, int playerWidth, int playerHeight)
+    void update(float deltaTime, const TileGrid& level, float playerX, float playerY, int playerWidth, int playerHeight)
     {
         if (!isActive) return;
 
         // Update position
+        float fromX = posX;
+        float fromY = posY;
         posX += velX * deltaTime;
         posY += velY * deltaTime;
         sprite.setPosition(posX, posY);
 
         // Check collision with level
-        if (checkLevelCollision(level, rows, cols)) {
+        if (checkLevelCollision(level, fromX, fromY)) {
             isActive = false; // Banish on hitting level geometry
             return;
         }
@@ -73,8 +78,23 @@ private:
     Sprite sprite;
     static const int CELL_SIZE = 32; // Must match game's cell size
 
-    bool checkLevelCollision(const char** level, int rows, int cols)
+    bool checkLevelCollision(const TileGrid& level, float fromX, float fromY)
     {
+        // Sweep the leading edges first, along x at the old height and then
+        // along y at the new columns, so a fast shot can't skip a thin wall.
+        auto solid = [](char c) { return tileHas(c, TILE_SOLID); };
+        int hit;
+        int fromCol = static_cast<int>((velX < 0 ? fromX : fromX + 16) / CELL_SIZE);
+        int toCol = static_cast<int>((velX < 0 ? posX : posX + 16) / CELL_SIZE);
+        if (sweepColumns(level, fromCol, toCol, static_cast<int>(fromY / CELL_SIZE), static_cast<int>((fromY + 16) / CELL_SIZE), solid, hit)) {
+            return true;
+        }
+        int fromRow = static_cast<int>((velY < 0 ? fromY : fromY + 16) / CELL_SIZE);
+        int toRow = static_cast<int>((velY < 0 ? posY : posY + 16) / CELL_SIZE);
+        if (sweepRows(level, fromRow, toRow, static_cast<int>(posX / CELL_SIZE), static_cast<int>((posX + 16) / CELL_SIZE), solid, hit)) {
+            return true;
+        }
+
         int leftCol = static_cast<int>(posX / CELL_SIZE);
         int rightCol = static_cast<int>((posX + 16) / CELL_SIZE); // Assuming 16x16 projectile size
         int topRow = static_cast<int>(posY / CELL_SIZE);
@@ -83,9 +103,9 @@ private:
         // Check all cells the projectile might intersect
         for (int y = topRow; y <= botRow; ++y) {
             for (int x = leftCol; x <= rightCol; ++x) {
-                if (x >= 0 && x < cols && y >= 0 && y < rows) {
-                    char c = level[y][x];
-                    if (c == 'w' || c == 'b' || c == 'p' || c == 'f') { // Collides with walls, blocks, platforms, floors
+                if (x >= 0 && x < level.getCols() && y >= 0 && y < level.getRows()) {
+                    char c = level.get(x, y);
+                    if (tileHas(c, TILE_SOLID)) {
                         return true;
                     }
                 }
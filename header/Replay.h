@@ -0,0 +1,162 @@
+#pragma once
+#include "Input.h"
+#include <fstream>
+#include <string>
+#include <cstdint>
+
+// Replay log layout (little-endian):
+//   "SHRP" | u16 version | u16 level | u32 seed | u8 mainIndex | u32 frameCount
+//   then runs of { u8 input bits, u16 repeat count } until frameCount steps are covered.
+// One entry is written per fixed simulation step, so playback is frame-exact.
+const char REPLAY_MAGIC[4] = { 'S', 'H', 'R', 'P' };
+const uint16_t REPLAY_VERSION = 1;
+// A log naming a level or main character the game does not have is rejected.
+const uint16_t REPLAY_LEVEL_COUNT = 3;     // levels 1..3
+const uint8_t REPLAY_CHARACTER_COUNT = 3;  // main index 0..2
+
+class InputRecorder {
+public:
+    InputRecorder() : frameCount(0), runBits(0), runLength(0), recording(false) {}
+
+    ~InputRecorder() {
+        finish();
+    }
+
+    bool begin(const std::string& filename, int level, unsigned int seed, int mainIndex) {
+        finish();
+        out.open(filename, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        out.write(REPLAY_MAGIC, 4);
+        writeU16(REPLAY_VERSION);
+        writeU16(static_cast<uint16_t>(level));
+        writeU32(seed);
+        uint8_t index = static_cast<uint8_t>(mainIndex);
+        out.write(reinterpret_cast<const char*>(&index), 1);
+        frameCountPos = out.tellp();
+        writeU32(0); // patched in finish()
+
+        frameCount = 0;
+        runLength = 0;
+        recording = true;
+        return true;
+    }
+
+    void record(const InputState& input) {
+        if (!recording) return;
+        unsigned char bits = input.toBits();
+        if (runLength > 0 && (bits != runBits || runLength == 0xFFFF)) flushRun();
+        runBits = bits;
+        runLength++;
+        frameCount++;
+    }
+
+    void finish() {
+        if (!recording) return;
+        if (runLength > 0) flushRun();
+        out.seekp(frameCountPos);
+        writeU32(frameCount);
+        out.close();
+        recording = false;
+    }
+
+    bool isRecording() const { return recording; }
+    uint32_t getFrameCount() const { return frameCount; }
+
+private:
+    std::ofstream out;
+    std::streampos frameCountPos;
+    uint32_t frameCount;
+    unsigned char runBits;
+    uint16_t runLength;
+    bool recording;
+
+    void flushRun() {
+        out.write(reinterpret_cast<const char*>(&runBits), 1);
+        writeU16(runLength);
+        runLength = 0;
+    }
+
+    void writeU16(uint16_t value) {
+        unsigned char bytes[2] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8) };
+        out.write(reinterpret_cast<const char*>(bytes), 2);
+    }
+
+    void writeU32(uint32_t value) {
+        unsigned char bytes[4] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+            static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24) };
+        out.write(reinterpret_cast<const char*>(bytes), 4);
+    }
+};
+
+// Plays a recorded log back as an input source, one state per simulation step.
+class ReplayInput : public InputSource {
+public:
+    ReplayInput() : level(1), seed(0), mainIndex(0), frameCount(0), framesPlayed(0), runBits(0), runRemaining(0) {}
+
+    bool open(const std::string& filename) {
+        in.close();
+        in.clear();
+        in.open(filename, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        char magic[4];
+        uint16_t version, storedLevel;
+        uint8_t index;
+        if (!in.read(magic, 4) || magic[0] != REPLAY_MAGIC[0] || magic[1] != REPLAY_MAGIC[1] ||
+            magic[2] != REPLAY_MAGIC[2] || magic[3] != REPLAY_MAGIC[3]) return false;
+        if (!readU16(version) || version != REPLAY_VERSION) return false;
+        if (!readU16(storedLevel) || !readU32(seed)) return false;
+        if (!in.read(reinterpret_cast<char*>(&index), 1) || !readU32(frameCount)) return false;
+        if (storedLevel < 1 || storedLevel > REPLAY_LEVEL_COUNT || index >= REPLAY_CHARACTER_COUNT) return false;
+
+        level = storedLevel;
+        mainIndex = index;
+        framesPlayed = 0;
+        runRemaining = 0;
+        return true;
+    }
+
+    InputState poll() override {
+        if (isFinished()) return InputState();
+        if (runRemaining == 0) {
+            if (!in.read(reinterpret_cast<char*>(&runBits), 1) || !readU16(runRemaining) || runRemaining == 0) {
+                framesPlayed = frameCount;
+                return InputState();
+            }
+        }
+        runRemaining--;
+        framesPlayed++;
+        return InputState::fromBits(runBits);
+    }
+
+    bool isFinished() const { return framesPlayed >= frameCount; }
+    int getLevel() const { return level; }
+    unsigned int getSeed() const { return seed; }
+    int getMainIndex() const { return mainIndex; }
+    int getFrameCount() const { return static_cast<int>(frameCount); }
+
+private:
+    std::ifstream in;
+    int level;
+    uint32_t seed;
+    int mainIndex;
+    uint32_t frameCount;
+    uint32_t framesPlayed;
+    unsigned char runBits;
+    uint16_t runRemaining;
+
+    bool readU16(uint16_t& value) {
+        unsigned char bytes[2];
+        if (!in.read(reinterpret_cast<char*>(bytes), 2)) return false;
+        value = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+        return true;
+    }
+
+    bool readU32(uint32_t& value) {
+        unsigned char bytes[4];
+        if (!in.read(reinterpret_cast<char*>(bytes), 4)) return false;
+        value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        return true;
+    }
+};
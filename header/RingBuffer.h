@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+
+// Fixed-capacity FIFO over an inline array. N must be a power of two so the
+// read and write counters can run freely and be masked into the array; they
+// wrap around harmlessly since only their difference is used. Nothing is
+// allocated, so a buffer copies like any other value.
+//
+// With Concurrent set, one thread may enqueue while another dequeues, without
+// locks: each side only writes its own counter and publishes it with release
+// ordering. Such a buffer cannot be copied, and clear() is only safe while
+// neither side is using it. One producer and one consumer only.
+template <bool Concurrent>
+struct RingCounter {
+    unsigned value;
+
+    RingCounter() : value(0) {}
+    unsigned load() const { return value; }
+    unsigned loadOwn() const { return value; }
+    void store(unsigned v) { value = v; }
+};
+
+// Kept on separate cache lines so the two threads do not contend for one.
+template <>
+struct alignas(64) RingCounter<true> {
+    std::atomic<unsigned> value;
+
+    RingCounter() : value(0) {}
+    unsigned load() const { return value.load(std::memory_order_acquire); }
+    unsigned loadOwn() const { return value.load(std::memory_order_relaxed); }
+    void store(unsigned v) { value.store(v, std::memory_order_release); }
+};
+
+template <typename T, int N, bool Concurrent = false>
+class RingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    static const int CAPACITY = N;
+
+    bool isEmpty() const { return head.load() == tail.load(); }
+    bool isFull() const { return getSize() == N; }
+    int getSize() const { return static_cast<int>(tail.load() - head.load()); }
+
+    void clear() {
+        head.store(0);
+        tail.store(0);
+    }
+
+    // Producer side. Returns false, leaving the buffer as it was, when full.
+    bool enqueue(const T& item) {
+        unsigned rear = tail.loadOwn();
+        if (rear - head.load() == static_cast<unsigned>(N)) return false;
+        items[rear & (N - 1)] = item;
+        tail.store(rear + 1);
+        return true;
+    }
+
+    // Consumer side. An empty buffer yields a value-initialised T.
+    T dequeue() {
+        unsigned front = head.loadOwn();
+        if (front == tail.load()) return T();
+        T item = items[front & (N - 1)];
+        head.store(front + 1);
+        return item;
+    }
+
+    T peek() const {
+        unsigned front = head.loadOwn();
+        if (front == tail.load()) return T();
+        return items[front & (N - 1)];
+    }
+
+private:
+    T items[N];
+    RingCounter<Concurrent> head; // next item to read
+    RingCounter<Concurrent> tail; // next slot to write
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cmath>
+
+// Broad phase for entities that move around the level. Each entity is filed
+// under the grid cell holding its top-left corner, so moving it only touches
+// the hash when it crosses a cell boundary. Queries widen the area by the
+// largest entity inserted so everything that can overlap it is returned;
+// callers still do the exact overlap test on the candidates.
+class SpatialHash {
+public:
+    // bucketCount must be a power of two.
+    SpatialHash(int capacity, int cellSize, int bucketCount = 4096)
+        : capacity(capacity), cellSize(cellSize), bucketMask(bucketCount - 1), maxWidth(0.0f), maxHeight(0.0f)
+    {
+        heads = new int[bucketCount];
+        next = new int[capacity];
+        prev = new int[capacity];
+        cellXs = new int[capacity];
+        cellYs = new int[capacity];
+        present = new bool[capacity];
+        for (int i = 0; i < bucketCount; ++i) heads[i] = -1;
+        for (int i = 0; i < capacity; ++i) present[i] = false;
+    }
+
+    ~SpatialHash() {
+        delete[] heads;
+        delete[] next;
+        delete[] prev;
+        delete[] cellXs;
+        delete[] cellYs;
+        delete[] present;
+    }
+
+    void clear() {
+        for (int i = 0; i <= bucketMask; ++i) heads[i] = -1;
+        for (int i = 0; i < capacity; ++i) present[i] = false;
+        maxWidth = 0.0f;
+        maxHeight = 0.0f;
+    }
+
+    void insert(int id, const sf::FloatRect& bounds) {
+        if (id < 0 || id >= capacity) return;
+        if (present[id]) unlink(id);
+        if (bounds.width > maxWidth) maxWidth = bounds.width;
+        if (bounds.height > maxHeight) maxHeight = bounds.height;
+        link(id, cellOf(bounds.left), cellOf(bounds.top));
+    }
+
+    // Call after the entity moved; cheap when it stays in the same cell.
+    void update(int id, const sf::FloatRect& bounds) {
+        if (id < 0 || id >= capacity) return;
+        if (present[id] && cellXs[id] == cellOf(bounds.left) && cellYs[id] == cellOf(bounds.top)) return;
+        insert(id, bounds);
+    }
+
+    void remove(int id) {
+        if (id < 0 || id >= capacity || !present[id]) return;
+        unlink(id);
+    }
+
+    bool contains(int id) const { return id >= 0 && id < capacity && present[id]; }
+
+    // Writes the ids of entities that may overlap area into results, in
+    // ascending order, and returns how many were written. At most maxResults
+    // are kept; total, if given, receives how many there were, so a caller can
+    // tell the results were cut short (*total > the return value).
+    int query(const sf::FloatRect& area, int* results, int maxResults, int* total = nullptr) const {
+        int count = 0;
+        int found = 0;
+        int firstX = cellOf(area.left - maxWidth);
+        int lastX = cellOf(area.left + area.width);
+        int firstY = cellOf(area.top - maxHeight);
+        int lastY = cellOf(area.top + area.height);
+
+        for (int cy = firstY; cy <= lastY; ++cy) {
+            for (int cx = firstX; cx <= lastX; ++cx) {
+                for (int id = heads[bucketOf(cx, cy)]; id != -1; id = next[id]) {
+                    if (cellXs[id] != cx || cellYs[id] != cy) continue; // hash collision
+                    found++;
+                    if (count < maxResults) results[count++] = id;
+                }
+            }
+        }
+        if (total) *total = found;
+        return sortResults(results, count);
+    }
+
+private:
+    int capacity;
+    int cellSize;
+    int bucketMask;
+    int* heads;
+    int* next;
+    int* prev;
+    int* cellXs;
+    int* cellYs;
+    bool* present;
+    float maxWidth, maxHeight;
+
+    SpatialHash(const SpatialHash&) = delete;
+    SpatialHash& operator=(const SpatialHash&) = delete;
+
+    int cellOf(float v) const {
+        return static_cast<int>(std::floor(v / cellSize));
+    }
+
+    int bucketOf(int cx, int cy) const {
+        unsigned int h = static_cast<unsigned int>(cx) * 73856093u ^ static_cast<unsigned int>(cy) * 19349663u;
+        return static_cast<int>(h & static_cast<unsigned int>(bucketMask));
+    }
+
+    void link(int id, int cx, int cy) {
+        int bucket = bucketOf(cx, cy);
+        cellXs[id] = cx;
+        cellYs[id] = cy;
+        prev[id] = -1;
+        next[id] = heads[bucket];
+        if (heads[bucket] != -1) prev[heads[bucket]] = id;
+        heads[bucket] = id;
+        present[id] = true;
+    }
+
+    void unlink(int id) {
+        if (prev[id] != -1) next[prev[id]] = next[id];
+        else heads[bucketOf(cellXs[id], cellYs[id])] = next[id];
+        if (next[id] != -1) prev[next[id]] = prev[id];
+        present[id] = false;
+    }
+
+    // Keeps callers visiting entities in index order, same as a linear scan.
+    static int sortResults(int* results, int count) {
+        for (int i = 1; i < count; ++i) {
+            int value = results[i];
+            int j = i - 1;
+            while (j >= 0 && results[j] > value) {
+                results[j + 1] = results[j];
+                j--;
+            }
+            results[j + 1] = value;
+        }
+        return count;
+    }
+};
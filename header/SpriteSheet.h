@@ -0,0 +1,20 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+// Where one source image lives once packed: the atlas page texture and the
+// rectangle the image covers on it. Loaded without an atlas, an image is a
+// page of its own and the rectangle covers the whole texture.
+struct SpriteSheet {
+    sf::Texture* texture;
+    sf::IntRect rect;
+
+    // Until loaded, a sheet points at an empty texture, so sprites built from
+    // it (headless runs) behave like sprites of a texture that failed to load.
+    SpriteSheet() : texture(&emptyTexture()), rect(0, 0, 0, 0) {}
+    SpriteSheet(sf::Texture* texture, const sf::IntRect& rect) : texture(texture), rect(rect) {}
+
+    static sf::Texture& emptyTexture() {
+        static sf::Texture texture;
+        return texture;
+    }
+};
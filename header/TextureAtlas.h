@@ -0,0 +1,267 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "SpriteSheet.h"
+#include "AssetLoader.h"
+#include "AssetCache.h"
+#include "Logger.h"
+#include <fstream>
+#include <string>
+
+// Serves images out of the atlas pages written by data/atlas_packer.cpp, so
+// sprites that share a page draw without rebinding textures. The manifest is
+//   page <index> <page image>
+//   <source image> <page index> <x> <y> <width> <height>
+// one line each. Images missing from the manifest (or every image, when no
+// atlas has been packed) are loaded on their own as single-image pages.
+//
+// A page is only resident while some requested image lives on it. request()
+// queues the page image on an AssetLoader the first time one of its images is
+// asked for, and update(), called from the main thread, uploads the pages that
+// finished decoding and fills in the sheets that were waiting on them. Once
+// release() has dropped the last image of a page, the AssetCache may evict it.
+// Page textures live in the cache, so a page some other owner already loaded
+// is reused instead of decoded again.
+//
+// With uploads turned off (headless runs) pages are decoded but never turned
+// into textures, so no GL context is needed; sheets then point at an empty
+// texture with the right rects, and getResidentBytes() still reports what the
+// pages would take up.
+class TextureAtlas {
+public:
+    static const int MAX_PAGES = 128;
+    static const int MAX_ENTRIES = 256;
+
+    TextureAtlas(AssetCache& assets) : assets(assets), pageCount(0), entryCount(0), requestCount(0), failed(false), uploads(true) {
+        for (int i = 0; i < MAX_PAGES; ++i) {
+            pageJobs[i] = -1;
+            pageUsers[i] = 0;
+        }
+    }
+
+    void setUploads(bool on) { uploads = on; }
+
+    // Reads the manifest; pages load as their images are requested. Returns false if there is no
+    // usable atlas; request() then falls back to loose images.
+    bool load(const std::string& manifest) {
+        std::ifstream in(manifest);
+        if (!in.is_open()) return false;
+
+        int firstPage = pageCount;
+        std::string word;
+        while (in >> word) {
+            if (word == "page") {
+                int index;
+                std::string file;
+                in >> index >> file;
+                if (firstPage + index >= MAX_PAGES || firstPage + index != pageCount) {
+                    LOG_ERROR("ATLAS ERROR: Bad page entry in %s", manifest.c_str());
+                    return false;
+                }
+                addPage(file);
+            }
+            else if (entryCount < MAX_ENTRIES) {
+                Entry& entry = entries[entryCount];
+                int page;
+                in >> page >> entry.rect.left >> entry.rect.top >> entry.rect.width >> entry.rect.height;
+                if (firstPage + page >= pageCount) {
+                    LOG_ERROR("ATLAS ERROR: %s refers to a missing page", word.c_str());
+                    continue;
+                }
+                entry.name = word;
+                entry.page = firstPage + page;
+                entry.wholePage = false;
+                entryCount++;
+            }
+        }
+        LOG_INFO("Read atlas %s: %d pages, %d images.", manifest.c_str(), pageCount - firstPage, entryCount);
+        return true;
+    }
+
+    // Asks for the image at path; sheet is filled in by a later update() once
+    // its page is uploaded, and must stay alive until then.
+    bool request(const std::string& path, SpriteSheet& sheet) {
+        int entry = findEntry(path);
+        if (entry < 0) {
+            if (pageCount >= MAX_PAGES || entryCount >= MAX_ENTRIES) return false;
+            entry = entryCount++;
+            entries[entry].name = path;
+            entries[entry].page = pageCount;
+            entries[entry].wholePage = true;
+            addPage(path);
+        }
+        if (requestCount >= MAX_ENTRIES) return false;
+        usePage(entries[entry].page);
+        requests[requestCount].sheet = &sheet;
+        requests[requestCount].entry = entry;
+        requestCount++;
+        return true;
+    }
+
+    // Gives back an image request() was asked for and resets sheet to the empty
+    // texture. Its page stays resident while other images on it are in use.
+    void release(const std::string& path, SpriteSheet& sheet) {
+        int entry = findEntry(path);
+        if (entry < 0) return;
+        int waiting = 0;
+        for (int i = 0; i < requestCount; ++i) {
+            if (requests[i].sheet != &sheet) requests[waiting++] = requests[i];
+        }
+        requestCount = waiting;
+        sheet = SpriteSheet();
+
+        int page = entries[entry].page;
+        if (pageUsers[page] > 0 && --pageUsers[page] == 0) pages[page].reset();
+    }
+
+    // Uploads decoded pages and resolves waiting requests. Main thread only;
+    // returns true once nothing is outstanding.
+    bool update() {
+        for (int i = 0; i < pageCount; ++i) {
+            if (pageJobs[i] < 0) continue;
+            AssetLoader::JobState state = loader.getState(pageJobs[i]);
+            if (state == AssetLoader::Decoded) {
+                // The page may have been released meanwhile, or another owner
+                // may have loaded the same file.
+                if (pages[i].isValid() && !pages[i].isLoaded()) {
+                    pageSizes[i] = loader.getImage(pageJobs[i]).getSize();
+                    if (!uploads || pages[i]->loadFromImage(loader.getImage(pageJobs[i]))) pages[i].markLoaded();
+                    else failPage(i);
+                }
+                loader.releaseImage(pageJobs[i]);
+                pageJobs[i] = -1;
+            }
+            else if (state == AssetLoader::Failed) {
+                if (pageUsers[i] > 0) failPage(i);
+                pageJobs[i] = -1;
+            }
+        }
+
+        int waiting = 0;
+        for (int i = 0; i < requestCount; ++i) {
+            Entry& entry = entries[requests[i].entry];
+            if (pageJobs[entry.page] >= 0) {
+                requests[waiting++] = requests[i];
+                continue;
+            }
+            if (!pages[entry.page].isValid()) continue; // sheet keeps the empty texture
+            if (entry.wholePage) {
+                entry.rect = sf::IntRect(0, 0, pageSizes[entry.page].x, pageSizes[entry.page].y);
+            }
+            *requests[i].sheet = SpriteSheet(pages[entry.page].get(), entry.rect);
+        }
+        requestCount = waiting;
+
+        bool finished = isFinished();
+        if (finished) loader.clear();
+        return finished;
+    }
+
+    // Blocks until update() has nothing outstanding, sleeping on the loader
+    // between uploads instead of polling. Main thread only.
+    void finish() {
+        while (!update()) loader.wait();
+    }
+
+    bool isFinished() const {
+        if (requestCount > 0) return false;
+        for (int i = 0; i < pageCount; ++i) {
+            if (pageJobs[i] >= 0) return false;
+        }
+        return true;
+    }
+
+    // Share of the wanted pages uploaded so far, for a progress bar.
+    float getProgress() const {
+        int wanted = 0, done = 0;
+        for (int i = 0; i < pageCount; ++i) {
+            if (pageUsers[i] == 0) continue;
+            wanted++;
+            if (pageJobs[i] < 0) done++;
+        }
+        return wanted == 0 ? 1.0f : static_cast<float>(done) / wanted;
+    }
+
+    bool hasFailed() const { return failed; }
+
+    // Pixel bytes of the resident pages, from their decoded size, so it is the
+    // same with or without uploads.
+    size_t getResidentBytes() const {
+        size_t bytes = 0;
+        for (int i = 0; i < pageCount; ++i) {
+            if (pageUsers[i] > 0 && pageJobs[i] < 0) bytes += static_cast<size_t>(pageSizes[i].x) * pageSizes[i].y * 4;
+        }
+        return bytes;
+    }
+
+    int getResidentPageCount() const {
+        int resident = 0;
+        for (int i = 0; i < pageCount; ++i) {
+            if (pageUsers[i] > 0) resident++;
+        }
+        return resident;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        int page;
+        sf::IntRect rect;
+        bool wholePage; // loose image; rect is known once it is decoded
+    };
+
+    struct Request {
+        SpriteSheet* sheet;
+        int entry;
+    };
+
+    AssetCache& assets;
+    AssetLoader loader;
+    TextureHandle pages[MAX_PAGES];
+    int pageJobs[MAX_PAGES]; // loader job still decoding the page, -1 once uploaded
+    int pageUsers[MAX_PAGES]; // requested images on the page; 0 means not resident
+    sf::Vector2u pageSizes[MAX_PAGES]; // decoded size, known once uploaded
+    std::string pageFiles[MAX_PAGES];
+    int pageCount;
+    Entry entries[MAX_ENTRIES];
+    int entryCount;
+    Request requests[MAX_ENTRIES];
+    int requestCount;
+    bool failed;
+    bool uploads;
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    int findEntry(const std::string& path) const {
+        for (int i = 0; i < entryCount; ++i) {
+            if (entries[i].name == path) return i;
+        }
+        return -1;
+    }
+
+    void addPage(const std::string& file) {
+        pageFiles[pageCount] = file;
+        pageJobs[pageCount] = -1;
+        pageUsers[pageCount] = 0;
+        pageSizes[pageCount] = sf::Vector2u(0, 0);
+        pageCount++;
+    }
+
+    // Makes a page resident, queueing its image unless the cache still has it
+    // or a decode from before a release is still running.
+    void usePage(int page) {
+        if (pageUsers[page]++ > 0) return;
+        pages[page] = assets.acquireTexture(pageFiles[page]);
+        if (!pages[page].isValid()) failPage(page);
+        else if (pages[page].isLoaded() && uploads) pageSizes[page] = pages[page]->getSize();
+        else if (!pages[page].isLoaded() && pageJobs[page] < 0) {
+            pageJobs[page] = loader.request(pageFiles[page]);
+            if (pageJobs[page] < 0) failPage(page);
+        }
+    }
+
+    void failPage(int page) {
+        LOG_ERROR("ATLAS ERROR: Could not load %s", pageFiles[page].c_str());
+        failed = true;
+    }
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <cassert>
+#include <cstring>
+
+// The level's tiles in one contiguous allocation, row-major with a fixed
+// stride. A border of `padding` empty cells surrounds the map, so probes that
+// step a cell or two past an edge read ' ' through at() without a bounds check.
+//
+// When a level is streamed the grid only holds a window of windowCols columns
+// starting at originCol; coordinates stay level-wide, getCols() still reports
+// the full level width, and columns outside the window read as empty.
+//
+// The cells can also live in memory the grid does not own (a mapped level
+// file, see attach()); the owner must keep it alive until the grid is cleared.
+class TileGrid {
+public:
+    static const int DEFAULT_PADDING = 2;
+    static const char EMPTY = ' ';
+
+    TileGrid() : cells(nullptr), ownsCells(false), rows(0), cols(0), originCol(0), windowCols(0), padding(0), stride(0) {}
+
+    ~TileGrid() {
+        release();
+    }
+
+    // Drops the old contents; every cell, including the border, starts empty.
+    void resize(int rows, int cols, int padding = DEFAULT_PADDING) {
+        resizeWindow(rows, cols, cols, padding);
+    }
+
+    // Same as resize(), but only windowCols columns of the level are held at once.
+    void resizeWindow(int rows, int cols, int windowCols, int padding = DEFAULT_PADDING) {
+        release();
+        this->rows = rows;
+        this->cols = cols;
+        this->windowCols = windowCols < cols ? windowCols : cols;
+        this->padding = padding;
+        originCol = 0;
+        stride = this->windowCols + 2 * padding;
+        int total = stride * (rows + 2 * padding);
+        cells = new char[total];
+        ownsCells = true;
+        for (int i = 0; i < total; ++i) cells[i] = EMPTY;
+    }
+
+    // Uses an existing padded image of the whole level, laid out exactly as
+    // resize() would (stride cols + 2 * padding), without copying it.
+    void attach(char* image, int rows, int cols, int padding) {
+        release();
+        cells = image;
+        ownsCells = false;
+        this->rows = rows;
+        this->cols = cols;
+        this->windowCols = cols;
+        this->padding = padding;
+        originCol = 0;
+        stride = cols + 2 * padding;
+    }
+
+    void clear() {
+        release();
+        rows = cols = originCol = windowCols = padding = stride = 0;
+    }
+
+    // Slides the window so it starts at column origin. Columns still covered
+    // keep their contents; newly uncovered ones start empty until filled.
+    void setOrigin(int origin) {
+        int shift = origin - originCol;
+        if (shift == 0 || !cells) return;
+        for (int y = 0; y < rows; ++y) {
+            char* row = rowData(y);
+            if (shift > 0 && shift < windowCols) {
+                memmove(row, row + shift, windowCols - shift);
+                memset(row + windowCols - shift, EMPTY, shift);
+            }
+            else if (shift < 0 && -shift < windowCols) {
+                memmove(row - shift, row, windowCols + shift);
+                memset(row, EMPTY, -shift);
+            }
+            else {
+                memset(row, EMPTY, windowCols);
+            }
+        }
+        originCol = origin;
+    }
+
+    bool isEmpty() const { return cells == nullptr; }
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getPadding() const { return padding; }
+    int getOriginCol() const { return originCol; }
+    int getWindowCols() const { return windowCols; }
+    bool isStreamed() const { return windowCols < cols; }
+
+    // True for cells of the map that are currently held in the window.
+    bool contains(int x, int y) const {
+        return x >= originCol && x < originCol + windowCols && y >= 0 && y < rows;
+    }
+
+    // Unchecked read; valid for any cell of the window or its padded border.
+    // Callers bounding x by getCols() rather than the window must use get().
+    char at(int x, int y) const {
+        assert(x >= originCol - padding && x < originCol + windowCols + padding && y >= -padding && y < rows + padding);
+        return cells[(y + padding) * stride + x - originCol + padding];
+    }
+
+    // Checked read; everything outside the window's padded border is empty.
+    char get(int x, int y) const {
+        if (!cells || x < originCol - padding || x >= originCol + windowCols + padding || y < -padding || y >= rows + padding) return EMPTY;
+        return at(x, y);
+    }
+
+    // Only cells of the map itself can be written; the border stays empty.
+    void set(int x, int y, char c) {
+        if (contains(x, y)) cells[(y + padding) * stride + x - originCol + padding] = c;
+    }
+
+    // First of the windowCols cells of row y (column originCol), for bulk loading and saving.
+    char* rowData(int y) { return &cells[(y + padding) * stride + padding]; }
+    const char* rowData(int y) const { return &cells[(y + padding) * stride + padding]; }
+
+    // The whole padded allocation, (rows + 2 * padding) * getStride() bytes, for bulk copies.
+    char* data() { return cells; }
+    const char* data() const { return cells; }
+    int getStride() const { return stride; }
+
+private:
+    char* cells;
+    bool ownsCells;
+    int rows, cols;
+    int originCol, windowCols;
+    int padding;
+    int stride;
+
+    void release() {
+        if (ownsCells) delete[] cells;
+        cells = nullptr;
+        ownsCells = false;
+    }
+
+    TileGrid(const TileGrid&) = delete;
+    TileGrid& operator=(const TileGrid&) = delete;
+};
@@ -0,0 +1,214 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "TileGrid.h"
+#include "SpriteSheet.h"
+
+// Batches the level tiles into one vertex array per tile texture so a whole
+// level is drawn with a handful of draw calls instead of one per cell. Tile
+// types whose sheets share an atlas page share a vertex array too.
+// Arrays are split into strips of StripWidth columns so only the strips
+// under the camera are submitted. For a streamed level only the grid's
+// resident window is batched; build() again whenever the window moves.
+class TileMap {
+public:
+    static const int Wall = 0;
+    static const int Block = 1;
+    static const int Platform = 2;
+    static const int Crystal = 3;
+    static const int Block3 = 4;
+    static const int Spike = 5;
+    static const int Pit = 6;
+    static const int Grass = 7;
+    static const int Block4 = 8;
+    static const int TypeCount = 9;
+    static const int StripWidth = 16;
+
+    TileMap() : layers(nullptr), slots(nullptr), rows(0), cols(0), originCol(0), cellSize(0), stripCount(0) {
+        for (int i = 0; i < TypeCount; ++i) layerOf[i] = i;
+    }
+
+    ~TileMap() {
+        delete[] layers;
+        delete[] slots;
+    }
+
+    static int typeOf(char c) {
+        switch (c) {
+        case 'w': case 'f': case 'r': return Wall;
+        case 'b': return Block;
+        case 'p': return Platform;
+        case 'c': return Crystal;
+        case 'l': return Block3;
+        case 'u': return Spike;
+        case 'x': return Pit;
+        case 'g': return Grass;
+        case 'N': return Block4;
+        default: return -1;
+        }
+    }
+
+    // Set every type's sheet before build(); types are grouped by page then.
+    // Types whose sheet is still empty (not loaded) get no quads.
+    void setTexture(int type, const SpriteSheet& sheet) {
+        sheets[type] = sheet;
+        for (int i = 0; i < TypeCount; ++i) {
+            layerOf[i] = i;
+            for (int j = 0; j < i; ++j) {
+                if (hasImage(j) && sheets[j].texture == sheets[i].texture) {
+                    layerOf[i] = j;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Rebuilds every layer from scratch; call after a map is loaded or the streamed window moved.
+    void build(const TileGrid& level, int cellSize) {
+        delete[] layers;
+        delete[] slots;
+        rows = level.getRows();
+        cols = level.getWindowCols();
+        originCol = level.getOriginCol();
+        this->cellSize = cellSize;
+        stripCount = (cols + StripWidth - 1) / StripWidth;
+        layers = new sf::VertexArray[stripCount * TypeCount];
+        for (int i = 0; i < stripCount * TypeCount; ++i) layers[i].setPrimitiveType(sf::Quads);
+        slots = new Slot[rows * cols];
+
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x) {
+                slots[y * cols + x].type = -1;
+                slots[y * cols + x].index = 0;
+                addQuad(x, y, typeOf(level.at(originCol + x, y)));
+            }
+        }
+    }
+
+    // Patches the quad of a single cell after the map was edited (e.g. a block
+    // broken by Knuckles). The quad is rewritten in place when the new type
+    // shares its layer; otherwise it is removed, so the arrays never grow past
+    // one quad per cell.
+    void updateCell(const TileGrid& level, int levelX, int y) {
+        int x = levelX - originCol;
+        if (!slots || x < 0 || x >= cols || y < 0 || y >= rows) return;
+        Slot& slot = slots[y * cols + x];
+        int type = typeOf(level.at(levelX, y));
+        if (!isDrawn(type)) type = -1;
+        if (type == slot.type) return;
+
+        if (slot.type >= 0 && type >= 0 && layerOf[type] == layerOf[slot.type]) {
+            slot.type = type;
+            setQuad(&layer(x / StripWidth, layerOf[type])[slot.index], x, y, type);
+            return;
+        }
+        if (slot.type >= 0) removeQuad(x, y);
+        addQuad(x, y, type);
+    }
+
+    // Draws the strips overlapping columns [firstCol, lastCol].
+    void draw(sf::RenderWindow& window, const sf::RenderStates& states, int firstCol, int lastCol) const {
+        if (!layers) return;
+        firstCol -= originCol;
+        lastCol -= originCol;
+        if (lastCol < 0) return;
+        int firstStrip = firstCol < 0 ? 0 : firstCol / StripWidth;
+        int lastStrip = lastCol / StripWidth;
+        if (lastStrip >= stripCount) lastStrip = stripCount - 1;
+
+        for (int strip = firstStrip; strip <= lastStrip; ++strip) {
+            for (int i = 0; i < TypeCount; ++i) {
+                const sf::VertexArray& vertices = layers[strip * TypeCount + i];
+                if (vertices.getVertexCount() == 0) continue;
+                sf::RenderStates layerStates = states;
+                layerStates.texture = sheets[i].texture;
+                window.draw(vertices, layerStates);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        int type;
+        int index;
+    };
+
+    SpriteSheet sheets[TypeCount];
+    int layerOf[TypeCount]; // vertex array a type's quads go into
+    sf::VertexArray* layers;
+    Slot* slots;
+    int rows, cols;
+    int originCol;
+    int cellSize;
+    int stripCount;
+
+    TileMap(const TileMap&) = delete;
+    TileMap& operator=(const TileMap&) = delete;
+
+    sf::VertexArray& layer(int strip, int type) {
+        return layers[strip * TypeCount + type];
+    }
+
+    bool hasImage(int type) const {
+        return sheets[type].rect.width > 0 && sheets[type].rect.height > 0;
+    }
+
+    bool isDrawn(int type) const {
+        return type >= 0 && hasImage(type);
+    }
+
+    void addQuad(int x, int y, int type) {
+        if (!isDrawn(type)) return;
+
+        sf::VertexArray& vertices = layer(x / StripWidth, layerOf[type]);
+        Slot& slot = slots[y * cols + x];
+        slot.type = type;
+        slot.index = static_cast<int>(vertices.getVertexCount());
+        vertices.resize(vertices.getVertexCount() + 4);
+        setQuad(&vertices[slot.index], x, y, type);
+    }
+
+    void setQuad(sf::Vertex* quad, int x, int y, int type) const {
+        // Tiles are drawn at their image's native size, same as the old per-cell sprites.
+        float w = static_cast<float>(sheets[type].rect.width);
+        float h = static_cast<float>(sheets[type].rect.height);
+        float u = static_cast<float>(sheets[type].rect.left);
+        float v = static_cast<float>(sheets[type].rect.top);
+        float left = static_cast<float>((originCol + x) * cellSize);
+        float top = static_cast<float>(y * cellSize);
+
+        quad[0] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(u, v));
+        quad[1] = sf::Vertex(sf::Vector2f(left + w, top), sf::Vector2f(u + w, v));
+        quad[2] = sf::Vertex(sf::Vector2f(left + w, top + h), sf::Vector2f(u + w, v + h));
+        quad[3] = sf::Vertex(sf::Vector2f(left, top + h), sf::Vector2f(u, v + h));
+    }
+
+    // Drops the cell's quad by moving the layer's last quad into its place.
+    // Only runs when a tile is edited, so finding the moved quad's cell by
+    // scanning the strip is cheap enough.
+    void removeQuad(int x, int y) {
+        Slot& slot = slots[y * cols + x];
+        int strip = x / StripWidth;
+        int layerIndex = layerOf[slot.type];
+        sf::VertexArray& vertices = layer(strip, layerIndex);
+        int lastIndex = static_cast<int>(vertices.getVertexCount()) - 4;
+
+        if (slot.index != lastIndex) {
+            for (int i = 0; i < 4; ++i) vertices[slot.index + i] = vertices[lastIndex + i];
+            int firstCol = strip * StripWidth;
+            int endCol = firstCol + StripWidth < cols ? firstCol + StripWidth : cols;
+            for (int row = 0; row < rows; ++row) {
+                for (int col = firstCol; col < endCol; ++col) {
+                    Slot& moved = slots[row * cols + col];
+                    if (moved.type >= 0 && layerOf[moved.type] == layerIndex && moved.index == lastIndex) {
+                        moved.index = slot.index;
+                        row = rows;
+                        break;
+                    }
+                }
+            }
+        }
+        vertices.resize(lastIndex);
+        slot.type = -1;
+        slot.index = 0;
+    }
+};
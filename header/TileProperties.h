@@ -0,0 +1,43 @@
+#pragma once
+
+// Collision properties of every map character, looked up with one load and
+// mask instead of chains of character comparisons. Characters, enemies and
+// projectiles all read the same table, so a tile behaves the same for all of them.
+const unsigned char TILE_SOLID_SIDE = 1 << 0;   // blocks horizontal movement
+const unsigned char TILE_FLOOR = 1 << 1;        // can be stood on
+const unsigned char TILE_CEILING = 1 << 2;      // stops upward movement
+const unsigned char TILE_HAZARD = 1 << 3;       // spikes
+const unsigned char TILE_PIT = 1 << 4;          // bottomless pit
+const unsigned char TILE_BREAKABLE = 1 << 5;    // Knuckles can punch through it
+const unsigned char TILE_EDGE_SUPPORT = 1 << 6; // has a ledge the edge animation can hang off
+
+const unsigned char TILE_SOLID = TILE_SOLID_SIDE | TILE_FLOOR | TILE_CEILING;
+
+struct TilePropertyTable {
+    unsigned char flags[256];
+};
+
+constexpr TilePropertyTable makeTilePropertyTable() {
+    TilePropertyTable table = {};
+    table.flags['w'] = TILE_SOLID_SIDE;                                    // wall
+    table.flags['f'] = TILE_FLOOR | TILE_EDGE_SUPPORT;                     // floor
+    table.flags['r'] = TILE_CEILING;                                       // roof
+    table.flags['b'] = TILE_SOLID | TILE_EDGE_SUPPORT;                     // block
+    table.flags['p'] = TILE_FLOOR | TILE_EDGE_SUPPORT;                     // platform
+    table.flags['l'] = TILE_SOLID | TILE_BREAKABLE;                        // breakable block
+    table.flags['g'] = TILE_SOLID;                                         // grass
+    table.flags['N'] = TILE_SOLID;                                         // block 4
+    table.flags['u'] = TILE_HAZARD;                                        // spike
+    table.flags['x'] = TILE_PIT;                                           // pit
+    return table;
+}
+
+constexpr TilePropertyTable TILE_PROPERTIES = makeTilePropertyTable();
+
+inline unsigned char tileFlags(char c) {
+    return TILE_PROPERTIES.flags[static_cast<unsigned char>(c)];
+}
+
+inline bool tileHas(char c, unsigned char mask) {
+    return (tileFlags(c) & mask) != 0;
+}
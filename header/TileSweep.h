@@ -0,0 +1,49 @@
+#pragma once
+#include "TileGrid.h"
+
+// Swept tile tests for boxes moving one axis at a time. A box edge that moves
+// from one column (or row) to another crosses every line of cells in between,
+// so those are tested in the order the edge reaches them and the first one
+// that blocks wins. Checking only the destination lets a fast mover skip a
+// wall thinner than its step; the sweep stops it whatever its speed.
+//
+// Lines are cell indices. The line the edge starts in is skipped, since the
+// mover was already resolved against it, except when the edge stays there,
+// where it is the only line to test. Cells off the map never block, and nor
+// do columns of a streamed level outside the window (see TileGrid::get()).
+
+// First column between fromCol and toCol whose rows topRow..botRow hold a
+// tile blocks() accepts; false if the edge gets through.
+template <typename Blocks>
+bool sweepColumns(const TileGrid& level, int fromCol, int toCol, int topRow, int botRow, Blocks blocks, int& hitCol) {
+    int step = toCol > fromCol ? 1 : -1;
+    for (int col = fromCol == toCol ? toCol : fromCol + step; ; col += step) {
+        if (col >= 0 && col < level.getCols()) {
+            for (int y = topRow; y <= botRow; ++y) {
+                if (y >= 0 && y < level.getRows() && blocks(level.get(col, y))) {
+                    hitCol = col;
+                    return true;
+                }
+            }
+        }
+        if (col == toCol) return false;
+    }
+}
+
+// First row between fromRow and toRow whose columns leftCol..rightCol hold a
+// tile blocks() accepts; false if the edge gets through.
+template <typename Blocks>
+bool sweepRows(const TileGrid& level, int fromRow, int toRow, int leftCol, int rightCol, Blocks blocks, int& hitRow) {
+    int step = toRow > fromRow ? 1 : -1;
+    for (int row = fromRow == toRow ? toRow : fromRow + step; ; row += step) {
+        if (row >= 0 && row < level.getRows()) {
+            for (int x = leftCol; x <= rightCol; ++x) {
+                if (x >= 0 && x < level.getCols() && blocks(level.get(x, row))) {
+                    hitRow = row;
+                    return true;
+                }
+            }
+        }
+        if (row == toRow) return false;
+    }
+}